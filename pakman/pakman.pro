@@ -6,7 +6,7 @@
 
 QT       += core gui network xml
 
-LIBS     += -lkdeui -lqjson
+LIBS     += -lkdeui -lqjson -larchive
 
 greaterThan(QT_MAJOR_VERSION, 4): QT += widgets
 
@@ -52,11 +52,25 @@ SOURCES += src/main.cpp \
            src/ui/whatprovidesme.cpp \
            src/commands/curlcommands.cpp \
            src/commands/pacman.cpp \
+           src/commands/packagedetailparser.cpp \
+           src/commands/packagelistparser.cpp \
            src/commands/pacmancommands.cpp \
+           src/commands/pacmandatabase.cpp \
            src/commands/pacmanlogviewer.cpp \
            src/commands/taskprocessor.cpp \
            src/commands/terminal.cpp \
+           src/data/dependencygraph.cpp \
+           src/data/fileownershipindex.cpp \
+           src/data/packagearena.cpp \
+           src/data/packagebitset.cpp \
+           src/data/packagedetailcache.cpp \
+           src/data/packagenameindex.cpp \
            src/data/packagerepository.cpp \
+           src/data/packagesnapshot.cpp \
+           src/data/packagestore.cpp \
+           src/data/providesindex.cpp \
+           src/data/searchmatcher.cpp \
+           src/data/trigramindex.cpp \
            src/distribution/distributioninfo.cpp \
            src/distribution/archlinuxadapter.cpp \
            src/distribution/manjarolinuxadapter.cpp \
@@ -79,12 +93,26 @@ HEADERS += src/ui/groupbox.h \
            src/ui/whatprovidesme.h \
            src/commands/curlcommands.h \
            src/commands/pacman.h \
+           src/commands/packagedetailparser.h \
+           src/commands/packagelistparser.h \
            src/commands/pacmancommands.h \
+           src/commands/pacmandatabase.h \
            src/commands/pacmanlogviewer.h \
            src/commands/taskprocessor.h \
            src/commands/terminal.h \
            src/data/packagedata.h \
+           src/data/dependencygraph.h \
+           src/data/fileownershipindex.h \
+           src/data/packagearena.h \
+           src/data/packagebitset.h \
+           src/data/packagedetailcache.h \
+           src/data/packagenameindex.h \
            src/data/packagerepository.h \
+           src/data/packagesnapshot.h \
+           src/data/packagestore.h \
+           src/data/providesindex.h \
+           src/data/searchmatcher.h \
+           src/data/trigramindex.h \
            src/distribution/distributioninfo.h \
            src/distribution/archlinuxadapter.h \
            src/distribution/manjarolinuxadapter.h \
@@ -0,0 +1,206 @@
+/*
+* This file is part of pakman, an open-source GUI for pacman.
+* Copyright (C) 2014 Thomas Binkau
+*
+* This program is free software; you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation; either version 2 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+*
+*/
+
+#include "packagedetailparser.h"
+
+#include <cstring>
+
+
+namespace {
+
+enum EDetailField {
+	eFieldUnknown,
+	eFieldString,       // first line of the value
+	eFieldOptDepends,   // all lines of the value joined by <br>
+	eFieldBuildDate,
+	eFieldDownloadSize,
+	eFieldInstalledSize
+};
+
+struct DetailKey {
+	const char*                  key;
+	int                          length;
+	EDetailField                 field;
+	QString PackageDetailData::* member; // for eFieldString only
+};
+
+const int DETAIL_KEY_TABLE_SIZE = 30;
+
+/**
+ * @brief perfect hash table of all used keys, see hashDetailKey
+ */
+const DetailKey DETAIL_KEY_TABLE[DETAIL_KEY_TABLE_SIZE] = {
+	/*  0 */ { "Replaces",       8,  eFieldString,        &PackageDetailData::replaces      },
+	/*  1 */ { "Version",        7,  eFieldString,        &PackageDetailData::version       },
+	/*  2 */ { "URL",            3,  eFieldString,        &PackageDetailData::url           },
+	/*  3 */ { nullptr,          0,  eFieldUnknown,       nullptr                           },
+	/*  4 */ { nullptr,          0,  eFieldUnknown,       nullptr                           },
+	/*  5 */ { "Groups",         6,  eFieldString,        &PackageDetailData::group         },
+	/*  6 */ { "Repository",     10, eFieldString,        &PackageDetailData::repository    },
+	/*  7 */ { nullptr,          0,  eFieldUnknown,       nullptr                           },
+	/*  8 */ { nullptr,          0,  eFieldUnknown,       nullptr                           },
+	/*  9 */ { "Required By",    11, eFieldString,        &PackageDetailData::requiredBy    },
+	/* 10 */ { "Licenses",       8,  eFieldString,        &PackageDetailData::license       },
+	/* 11 */ { "Download Size",  13, eFieldDownloadSize,  nullptr                           },
+	/* 12 */ { "Packager",       8,  eFieldString,        &PackageDetailData::packager      },
+	/* 13 */ { "Conflicts With", 14, eFieldString,        &PackageDetailData::conflictsWith },
+	/* 14 */ { nullptr,          0,  eFieldUnknown,       nullptr                           },
+	/* 15 */ { "Installed Size", 14, eFieldInstalledSize, nullptr                           },
+	/* 16 */ { nullptr,          0,  eFieldUnknown,       nullptr                           },
+	/* 17 */ { "Architecture",   12, eFieldString,        &PackageDetailData::arch          },
+	/* 18 */ { nullptr,          0,  eFieldUnknown,       nullptr                           },
+	/* 19 */ { nullptr,          0,  eFieldUnknown,       nullptr                           },
+	/* 20 */ { "Provides",       8,  eFieldString,        &PackageDetailData::provides      },
+	/* 21 */ { nullptr,          0,  eFieldUnknown,       nullptr                           },
+	/* 22 */ { "Depends On",     10, eFieldString,        &PackageDetailData::dependsOn     },
+	/* 23 */ { "Optional For",   12, eFieldString,        &PackageDetailData::optionalFor   },
+	/* 24 */ { "Build Date",     10, eFieldBuildDate,     nullptr                           },
+	/* 25 */ { "Description",    11, eFieldString,        &PackageDetailData::description   },
+	/* 26 */ { "Optional Deps",  13, eFieldOptDepends,    nullptr                           },
+	/* 27 */ { nullptr,          0,  eFieldUnknown,       nullptr                           },
+	/* 28 */ { "Name",           4,  eFieldString,        &PackageDetailData::name          },
+	/* 29 */ { nullptr,          0,  eFieldUnknown,       nullptr                           }
+};
+
+inline int hashDetailKey(const char* key, const int length)
+{
+	return (length * 3 + static_cast<unsigned char>(key[0]) + static_cast<unsigned char>(key[1]) * 4)
+	       % DETAIL_KEY_TABLE_SIZE;
+}
+
+inline const DetailKey* findDetailKey(const char* key, const int length)
+{
+	if (length < 2)
+		return nullptr;
+	const DetailKey& entry = DETAIL_KEY_TABLE[hashDetailKey(key, length)];
+	if (entry.length != length || memcmp(entry.key, key, length) != 0)
+		return nullptr;
+	return &entry;
+}
+
+inline bool isSpace(const char c)
+{
+	return c == ' ' || c == '\t' || c == '\r';
+}
+
+inline const char* skipSpaces(const char* begin, const char* end)
+{
+	while (begin < end && isSpace(*begin)) ++begin;
+	return begin;
+}
+
+inline const char* trimEnd(const char* begin, const char* end)
+{
+	while (end > begin && isSpace(*(end - 1))) --end;
+	return end;
+}
+
+/**
+ * @brief first token of a size value ("1.23 MiB") as double, 0 if invalid
+ */
+double toSize(const char* begin, const char* end)
+{
+	const char* tokenEnd = begin;
+	while (tokenEnd < end && isSpace(*tokenEnd) == false) ++tokenEnd;
+
+	bool ok;
+	const double res = QString::fromLatin1(begin, tokenEnd - begin).toDouble(&ok);
+	return ok ? res : 0;
+}
+
+}
+
+
+PackageDetailParser::PackageDetailParser(QList<PackageDetailData>& output)
+	: m_output(output)
+{
+}
+
+void PackageDetailParser::parse(const char* data, const int length)
+{
+	const char*const end = data + length;
+
+	PackageDetailData pkg;
+	bool hasPackage = false;
+	const DetailKey* current = nullptr;
+
+	while (data < end) {
+		const char* eol = static_cast<const char*>(memchr(data, '\n', end - data));
+		if (eol == nullptr) eol = end;
+
+		if (data == eol) {
+			// end of package block
+			if (hasPackage) {
+				pkg.optDepends = pkg.optDepends.trimmed();
+				m_output.push_back(pkg);
+				pkg = PackageDetailData();
+				hasPackage = false;
+			}
+			current = nullptr;
+		}
+		else if (isSpace(*data)) {
+			// continuation line, only kept for optional dependencies
+			if (current != nullptr && current->field == eFieldOptDepends) {
+				pkg.optDepends += "<br>";
+				pkg.optDepends += QString::fromUtf8(data, trimEnd(data, eol) - data);
+			}
+		}
+		else {
+			const char*const colon = static_cast<const char*>(memchr(data, ':', eol - data));
+			if (colon != nullptr) {
+				const char*const keyEnd = trimEnd(data, colon);
+				current = findDetailKey(data, keyEnd - data);
+				hasPackage = true;
+
+				const char*const valueBegin = skipSpaces(colon + 1, eol);
+				const char*const valueEnd   = trimEnd(valueBegin, eol);
+				if (current != nullptr) {
+					switch (current->field) {
+					case eFieldString:
+						pkg.*(current->member) = QString::fromUtf8(valueBegin, valueEnd - valueBegin);
+						break;
+					case eFieldOptDepends:
+						pkg.optDepends = QString::fromUtf8(valueBegin, valueEnd - valueBegin);
+						break;
+					case eFieldBuildDate:
+						pkg.buildDate = QDateTime::fromString(QString::fromUtf8(valueBegin, valueEnd - valueBegin));
+						break;
+					case eFieldDownloadSize:
+						pkg.downloadSize = toSize(valueBegin, valueEnd);
+						break;
+					case eFieldInstalledSize:
+						pkg.installedSize = toSize(valueBegin, valueEnd);
+						break;
+					default:
+						break;
+					}
+				}
+			}
+			else current = nullptr;
+		}
+
+		data = eol + 1;
+	}
+
+	if (hasPackage) {
+		pkg.optDepends = pkg.optDepends.trimmed();
+		m_output.push_back(pkg);
+	}
+}
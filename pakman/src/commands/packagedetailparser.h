@@ -0,0 +1,58 @@
+/*
+* This file is part of pakman, an open-source GUI for pacman.
+* Copyright (C) 2014 Thomas Binkau
+*
+* This program is free software; you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation; either version 2 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+*
+*/
+
+#ifndef PACKAGEDETAILPARSER_H
+#define PACKAGEDETAILPARSER_H
+
+#include <QList>
+
+#include "src/data/packagedata.h"
+
+
+/**
+ * @brief single pass parser for the output of "-Si" / "-Qi"
+ *
+ * every line of a package block is visited once, the key is dispatched
+ * through a static perfect hash table and the value is written directly
+ * to PackageDetailData. Results are identical to Pacman::extractFieldFromInfo
+ * and the get* helpers in pacman.h.
+ *
+ * Name            : libfm
+ * Optional Deps   : udisks: removable device support
+ *                   gvfs: trash support [installed]
+ */
+class PackageDetailParser
+{
+public:
+	/**
+	 * @param output (parsed packages will be appended)
+	 */
+	explicit PackageDetailParser(QList<PackageDetailData>& output);
+
+	/**
+	 * @brief parses raw (utf8) output of one or more package blocks
+	 */
+	void parse(const char* data, const int length);
+
+private:
+	QList<PackageDetailData>& m_output;
+};
+
+#endif // PACKAGEDETAILPARSER_H
@@ -0,0 +1,185 @@
+/*
+* This file is part of pakman, an open-source GUI for pacman.
+* Copyright (C) 2014 Thomas Binkau
+*
+* This program is free software; you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation; either version 2 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+*
+*/
+
+#include "packagelistparser.h"
+
+#include <cstring>
+
+
+namespace {
+
+inline bool isSpace(const char c)
+{
+	return c == ' ' || c == '\t' || c == '\r';
+}
+
+inline const char* find(const char* begin, const char* end, const char c)
+{
+	const char*const pos = static_cast<const char*>(memchr(begin, c, end - begin));
+	return pos != nullptr ? pos : end;
+}
+
+inline const char* skipSpaces(const char* begin, const char* end)
+{
+	while (begin < end && isSpace(*begin)) ++begin;
+	return begin;
+}
+
+inline const char* trimEnd(const char* begin, const char* end)
+{
+	while (end > begin && isSpace(*(end - 1))) --end;
+	return end;
+}
+
+inline bool startsWith(const char* begin, const char* end, const char* prefix, const int prefixLength)
+{
+	return end - begin >= prefixLength && memcmp(begin, prefix, prefixLength) == 0;
+}
+
+}
+
+
+PackageListParser::PackageListParser(QList<PackageListData>& output)
+	: m_output(output), m_hasPackage(false), m_status(epkg_NON_INSTALLED)
+{
+}
+
+void PackageListParser::feed(const char* data, const int length)
+{
+	const char*const end = data + length;
+
+	// complete the line left over from the last chunk
+	if (m_incompleteLine.isEmpty() == false) {
+		const char*const eol = find(data, end, '\n');
+		m_incompleteLine.append(data, eol - data);
+		if (eol == end)
+			return;
+		parseLine(m_incompleteLine.constData(), m_incompleteLine.constData() + m_incompleteLine.size());
+		m_incompleteLine.clear();
+		data = eol + 1;
+	}
+
+	// all complete lines are parsed in place
+	while (data < end) {
+		const char*const eol = find(data, end, '\n');
+		if (eol == end) {
+			m_incompleteLine.append(data, end - data);
+			return;
+		}
+		parseLine(data, eol);
+		data = eol + 1;
+	}
+}
+
+void PackageListParser::finish()
+{
+	if (m_incompleteLine.isEmpty() == false) {
+		parseLine(m_incompleteLine.constData(), m_incompleteLine.constData() + m_incompleteLine.size());
+		m_incompleteLine.clear();
+	}
+	appendPackage();
+}
+
+void PackageListParser::parseLine(const char* begin, const char* end)
+{
+	if (begin == end)
+		return;
+
+	if (isSpace(*begin) == false) {
+		appendPackage();
+		parseHeader(begin, end);
+		return;
+	}
+
+	// This is a description!
+	if (m_hasPackage == false)
+		return;
+	begin = skipSpaces(begin, end);
+	end   = trimEnd(begin, end);
+	if (begin != end)
+		m_description += QString::fromUtf8(begin, end - begin);
+	else
+		m_description += ' ';
+}
+
+/*
+ * repo/name version (group1 group2) [installed: version]
+ */
+void PackageListParser::parseHeader(const char* begin, const char* end)
+{
+	// First we get repository and name!
+	const char* tokenEnd = find(begin, end, ' ');
+	const char* slash    = find(begin, tokenEnd, '/');
+	m_repository = QString::fromLatin1(begin, slash - begin);
+	m_name       = slash != tokenEnd ? QString::fromLatin1(slash + 1, tokenEnd - slash - 1) : QString();
+
+	begin    = skipSpaces(tokenEnd, end);
+	tokenEnd = find(begin, end, ' ');
+	m_version = QString::fromLatin1(begin, tokenEnd - begin);
+
+	m_status = epkg_NON_INSTALLED;
+	m_outdatedVersion.clear();
+	m_description.clear();
+	m_groups.clear();
+	m_hasPackage = true;
+
+	// optional annotations
+	begin = skipSpaces(tokenEnd, end);
+	while (begin < end) {
+		if (*begin == '(') {
+			// groups, separated by spaces
+			const char*const groupsEnd = find(begin, end, ')');
+			for (const char* group = skipSpaces(begin + 1, groupsEnd); group < groupsEnd; ) {
+				const char*const groupEnd = find(group, groupsEnd, ' ');
+				m_groups << QString::fromLatin1(group, groupEnd - group);
+				group = skipSpaces(groupEnd, groupsEnd);
+			}
+			begin = groupsEnd;
+		}
+		else if (startsWith(begin, end, "[installed]", 11)) {
+			//This is an installed package
+			m_status = epkg_INSTALLED;
+			begin += 10;
+		}
+		else if (startsWith(begin, end, "[installed:", 11)) {
+			//This is an outdated installed package
+			const char*const versionBegin = skipSpaces(begin + 11, end);
+			const char*const markerEnd    = find(versionBegin, end, ']');
+			m_status = epkg_OUTDATED;
+			m_outdatedVersion = QString::fromLatin1(versionBegin, trimEnd(versionBegin, markerEnd) - versionBegin);
+			begin = markerEnd;
+		}
+		else {
+			begin = find(begin, end, ' ');
+		}
+		begin = skipSpaces(begin + 1, end);
+	}
+}
+
+void PackageListParser::appendPackage()
+{
+	if (m_hasPackage == false)
+		return;
+
+	m_output.append(PackageListData(m_name, m_repository, m_version, m_name + " " + m_description,
+	                                m_status, m_outdatedVersion));
+	m_output.last().groups = m_groups;
+	m_hasPackage = false;
+}
@@ -0,0 +1,77 @@
+/*
+* This file is part of pakman, an open-source GUI for pacman.
+* Copyright (C) 2014 Thomas Binkau
+*
+* This program is free software; you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation; either version 2 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+*
+*/
+
+#ifndef PACKAGELISTPARSER_H
+#define PACKAGELISTPARSER_H
+
+#include <QByteArray>
+#include <QList>
+
+#include "src/data/packagedata.h"
+
+
+/**
+ * @brief single pass tokenizer for the output of "-Ss"
+ *
+ * works on the raw (utf8) output, fields are sliced as views and only the
+ * final fields are converted to QString. The output may be fed in chunks of
+ * any size, only an incomplete trailing line will be buffered.
+ *
+ * community/libfm 1.1.0-4 (lxde) [installed: 1.1.0-3]
+ *     Library for file management
+ */
+class PackageListParser
+{
+public:
+	/**
+	 * @param output (parsed packages will be appended)
+	 */
+	explicit PackageListParser(QList<PackageListData>& output);
+
+	/**
+	 * @brief parses all complete lines of data, the rest will be kept till the next call
+	 */
+	void feed(const char* data, const int length);
+	/**
+	 * @brief parses the remaining data and appends the last package
+	 */
+	void finish();
+
+private:
+	void parseLine(const char* begin, const char* end);
+	void parseHeader(const char* begin, const char* end);
+	void appendPackage();
+
+private:
+	QList<PackageListData>& m_output;
+	QByteArray m_incompleteLine; // tail of the last chunk
+
+	// current package
+	bool          m_hasPackage;
+	QString       m_name;
+	QString       m_repository;
+	QString       m_version;
+	QString       m_outdatedVersion;
+	QString       m_description;
+	QStringList   m_groups;
+	PackageStatus m_status;
+};
+
+#endif // PACKAGELISTPARSER_H
@@ -20,93 +20,70 @@
 
 #include "pacman.h"
 
+#include <algorithm>
+#include <cstring>
 #include <QStringList>
 #include <QSet>
 #include <QRegExp>
 #include "pacmancommands.h"
+#include "pacmandatabase.h"
+#include "packagelistparser.h"
+#include "packagedetailparser.h"
+#include "src/data/packagedetailcache.h"
 
 
 namespace Pacman {
+
+namespace {
+/**
+ * @brief details of all packages, filled by prefetchPackageDetails
+ */
+PackageDetailCache s_detailCache;
+
+std::unique_ptr<QList<PackageDetailData>> queryPackageDetails(const QString& pkgName, bool installedPackage)
+{
+	const QByteArray pkgInfoAll = PacmanCommands::getPackageDetails(pkgName, installedPackage);
+
+	auto output = new QList<PackageDetailData>();
+	PackageDetailParser parser(*output);
+	parser.parse(pkgInfoAll.constData(), pkgInfoAll.size());
+	return std::unique_ptr<QList<PackageDetailData>>(output);
+}
+}
+
 /*
  * Retrieves the list of all available packages in the database (installed + non-installed)
  *
- * from Octopi
+ * will read the sync databases directly if possible and fall back to "-Ss" otherwise
+ */
+std::unique_ptr<QList<PackageListData>> getPackageList(const TLocalPackages& localPackages)
+{
+	const PacmanDatabase::Configuration config = PacmanDatabase::getConfiguration();
+	if (PacmanDatabase::isAvailable(config)) {
+		std::unique_ptr<QList<PackageListData>> res = PacmanDatabase::getPackageList(config, localPackages);
+		if (res != nullptr) return res;
+	}
+	return getPackageListFromSearch();
+}
+
+/*
+ * Retrieves the list of all available packages by parsing the output of "-Ss"
+ *
+ * the output is parsed while pacman is still running
  */
-std::unique_ptr<QList<PackageListData>> getPackageList()
+std::unique_ptr<QList<PackageListData>> getPackageListFromSearch()
 {
 	//archlinuxfr/yaourt 1.2.2-1 [installed]
 	//    A pacman wrapper with extended features and AUR support
 	//community/libfm 1.1.0-4 (lxde) [installed: 1.1.0-3]
 
-	QString pkgList = PacmanCommands::getPackageList();
-	QString pkgName, pkgRepository, pkgVersion, pkgDescription, pkgOutVersion;
-	PackageStatus pkgStatus = epkg_NON_INSTALLED;
-	QStringList packageTuples = pkgList.split(QRegExp("\\n"), QString::SkipEmptyParts);
-	QList<PackageListData> * res = new QList<PackageListData>();
-
-	pkgDescription = "";
-	foreach(QString packageTuple, packageTuples)
-	{
-		if (!packageTuple[0].isSpace())
-		{
-			//Do we already have a description?
-			if (pkgDescription != "")
-			{
-				pkgDescription = pkgName + " " + pkgDescription;
-
-				PackageListData pld =
-					PackageListData(pkgName, pkgRepository, pkgVersion, pkgDescription, pkgStatus, pkgOutVersion);
-
-				res->append(pld);
-
-				pkgDescription = "";
-			}
-
-			//First we get repository and name!
-			QStringList parts = packageTuple.split(' ');
-			QString repoName = parts[0];
-			int a = repoName.indexOf("/");
-			pkgRepository = repoName.left(a);
-			pkgName = repoName.mid(a+1);
-			pkgVersion = parts[1];
-
-			if(packageTuple.indexOf("[installed]") != -1)
-			{
-				//This is an installed package
-				pkgStatus = epkg_INSTALLED;
-				pkgOutVersion = "";
-			}
-			else if (packageTuple.indexOf("[installed:") != -1)
-			{
-				//This is an outdated installed package
-				pkgStatus = epkg_OUTDATED;
-
-				int i = packageTuple.indexOf("[installed:");
-				pkgOutVersion = packageTuple.mid(i+11);
-				pkgOutVersion = pkgOutVersion.remove(']').trimmed();
-			}
-			else
-			{
-				//This is an uninstalled package
-				pkgStatus = epkg_NON_INSTALLED;
-				pkgOutVersion = "";
-			}
-		}
-		else
-		{
-			//This is a description!
-			if (!packageTuple.trimmed().isEmpty())
-				pkgDescription += packageTuple.trimmed();
-			else
-				pkgDescription += " "; //StrConstants::getNoDescriptionAvailabe();
-		}
-	}
+	QList<PackageListData>*const res = new QList<PackageListData>();
 
-	//And adds the very last package...
-	pkgDescription = pkgName + " " + pkgDescription;
-	PackageListData pld =
-		PackageListData(pkgName, pkgRepository, pkgVersion, pkgDescription, pkgStatus, pkgOutVersion);
-	res->append(pld);
+	PackageListParser parser(*res);
+	PacmanCommands::getPackageList([&parser](const char* data, int length) {
+		parser.feed(data, length);
+	});
+	parser.finish();
 
 	return std::unique_ptr<QList<PackageListData>>(res);
 }
@@ -141,84 +118,62 @@ std::unique_ptr<QList<PackageListData> > getPackageListForeign()
  *
  * based on Octopi
  */
-std::unique_ptr<QList<PackageDetailData>> getPackageDetails(const QString& pkgName, bool installedPackage)
+std::unique_ptr<QList<PackageDetailData>> getPackageDetails(const QString& pkgName, bool installedPackage,
+                                                            const qint64 stamp)
 {
-	QString pkgInfoAll(QString::fromUtf8(PacmanCommands::getPackageDetails(pkgName, installedPackage)));
-	QStringList pkgInfos = pkgInfoAll.split("\n\n", QString::SkipEmptyParts);
-
-	auto output = new QList<PackageDetailData>();
-	for (int x = 0; x < pkgInfos.size(); ++x)
-	{
-		PackageDetailData data;
-		const QString& pkgInfo = pkgInfos[x];
-
-		if (pkgInfo.isEmpty())
-			continue;
-
-		data.name = getName(pkgInfo);
-		data.repository = getRepository(pkgInfo);
-		data.version = getVersion(pkgInfo);
-		data.url = getURL(pkgInfo);
-		data.license = getLicense(pkgInfo);
-		data.group = getGroup(pkgInfo);
-		data.provides = getProvides(pkgInfo);
-		data.requiredBy = getRequiredBy(pkgInfo);
-		data.optionalFor = getOptionalFor(pkgInfo);
-		data.dependsOn = getDependsOn(pkgInfo);
-		data.optDepends = getOptDepends(pkgInfo);
-		data.conflictsWith = getConflictsWith(pkgInfo);
-		data.replaces = getReplaces(pkgInfo);
-		data.packager = getPackager(pkgInfo);
-		data.arch = getArch(pkgInfo);
-		data.description = getDescription(pkgInfo);
-		data.buildDate = getBuildDate(pkgInfo);
-		data.downloadSize = getDownloadSize(pkgInfo);
-		data.installedSize = getInstalledSize(pkgInfo);
-		output->push_back(data);
+	if (stamp != 0) {
+		std::unique_ptr<QList<PackageDetailData>> cached = s_detailCache.find(stamp, pkgName, installedPackage);
+		if (cached != nullptr) return cached;
 	}
-	return std::unique_ptr<QList<PackageDetailData>>(output);
+
+	return queryPackageDetails(pkgName, installedPackage);
 }
 
 /*
- * Retrieves the list of all package groups available
+ * Reads the details of all packages with one "-Si" and one "-Qi" call
  *
- * from Octopi
+ * the stamp is the one of the refresh, the next refresh will come with a new
+ * stamp if the databases change while pacman is running
  */
-std::unique_ptr<QStringList> getPackageGroups()
+void prefetchPackageDetails(const qint64 stamp, const std::atomic<bool>& cancelled)
 {
-	QString packagesFromGroup = PacmanCommands::getPackageGroups();
-	QStringList groups = packagesFromGroup.split(QRegExp("\\n"), QString::SkipEmptyParts);
-	QStringList* res = new QStringList();
+	if (stamp == 0 || s_detailCache.isValid(stamp)) return;
 
-	foreach(QString group, groups)
-	{
-		group = group.trimmed();
-		if (!group.isEmpty())
-			res->append(group); //We only return the group name
-	}
-
-	res->removeDuplicates();
-	res->sort();
-	return std::unique_ptr<QStringList>(res);
+	std::unique_ptr<QList<PackageDetailData>> syncDetails = queryPackageDetails("", false);
+	if (cancelled) return;
+	std::unique_ptr<QList<PackageDetailData>> localDetails = queryPackageDetails("", true);
+	if (cancelled) return;
+	s_detailCache.reset(stamp, std::move(syncDetails), std::move(localDetails));
 }
 
 /*
- * Retrieves the list of packages for a specific group
+ * Retrieves the installation state of all installed packages
+ *
+ * will read the local database directly if possible and fall back to "-Q", "-Qe" and "-Qt" otherwise
  */
-std::unique_ptr<QStringList> getPackageListForGroup(const QString& groupName)
+std::unique_ptr<TLocalPackages> getLocalPackages()
 {
-	QString packagesOfGroup = PacmanCommands::getPackageListForGroup(groupName);
-	QStringList packages = packagesOfGroup.split(QRegExp("\\n"), QString::SkipEmptyParts);
-	QStringList* res = new QStringList();
+	const PacmanDatabase::Configuration config = PacmanDatabase::getConfiguration();
+	if (PacmanDatabase::isLocalAvailable(config))
+		return PacmanDatabase::getLocalPackages(config);
 
-	foreach(QString packageTuple, packages) {
+	QString installedPkgList = PacmanCommands::getInstalledPackageList();
+	QStringList packageTuples = installedPkgList.split(QRegExp("\\n"), QString::SkipEmptyParts);
+	auto unrequired = getUnrequiredPackageList();
+	auto explicits  = getExplicitPackageList();
+	TLocalPackages* res = new TLocalPackages();
+
+	foreach(QString packageTuple, packageTuples)
+	{
 		QStringList parts = packageTuple.split(' ');
-		if (parts.size() == 2) {
-			res->append(parts[1]);
-		}
+		if (parts.size() < 2) continue;
+		LocalPackageData data;
+		data.version = parts[1];
+		data.explicitlyInstalled = explicits->contains(parts[0]);
+		data.required = unrequired->contains(parts[0]) == false;
+		res->insert(parts[0], data);
 	}
-
-	return std::unique_ptr<QStringList>(res);
+	return std::unique_ptr<TLocalPackages>(res);
 }
 
 /*
@@ -518,147 +473,269 @@ QString getDescription(const QString& pkgInfo)
 	return extractFieldFromInfo("Description", pkgInfo);
 }
 
+namespace {
+
+inline bool isDigit(const unsigned int c)
+{
+	return c >= '0' && c <= '9';
+}
+
+inline bool isAlpha(const unsigned int c)
+{
+	return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z');
+}
+
+inline bool isAlnum(const unsigned int c)
+{
+	return isDigit(c) || isAlpha(c);
+}
+
+/**
+ * @brief strcmp of two segments, -1 / 0 / 1
+ */
+template <typename TChar>
+inline int compareSegment(const TChar* one, const TChar*const end1, const TChar* two, const TChar*const end2)
+{
+	for (; one != end1 && two != end2; ++one, ++two) {
+		if (*one != *two) return *one < *two ? -1 : 1;
+	}
+	if (one != end1) return 1;
+	if (two != end2) return -1;
+	return 0;
+}
+
 /**
- * This function was copied from ArchLinux Pacman project
+ * @brief rpmvercmp on [one, end1) and [two, end2) without modifying or copying any of them
  *
- * Compare alpha and numeric segments of two versions.
- * return 1: a is newer than b
- *        0: a and b are the same version
- *       -1: b is newer than a
- */
-//TODO: checkme
-int rpmvercmp(const char *a, const char *b) {
-	char oldch1, oldch2;
-	char *str1, *str2;
-	char *ptr1, *ptr2;
-	char *one, *two;
-	int rc;
-	int isnum;
-	int ret = 0;
-
-  /* easy comparison to see if versions are identical */
-  if(strcmp(a, b) == 0) return 0;
-
-  str1 = strdup(a);
-  str2 = strdup(b);
-
-  one = ptr1 = str1;
-  two = ptr2 = str2;
-
-  /* loop through each version segment of str1 and str2 and compare them */
-  while (*one && *two) {
-    while (*one && !isalnum((int)*one)) one++;
-    while (*two && !isalnum((int)*two)) two++;
-
-    /* If we ran to the end of either, we are finished with the loop */
-    if (!(*one && *two)) break;
-
-    /* If the separator lengths were different, we are also finished */
-    if ((one - ptr1) != (two - ptr2)) {
-      return (one - ptr1) < (two - ptr2) ? -1 : 1;
-    }
-
-    ptr1 = one;
-    ptr2 = two;
-
-    /* grab first completely alpha or completely numeric segment */
-    /* leave one and two pointing to the start of the alpha or numeric */
-    /* segment and walk ptr1 and ptr2 to end of segment */
-    if (isdigit((int)*ptr1)) {
-      while (*ptr1 && isdigit((int)*ptr1)) ptr1++;
-      while (*ptr2 && isdigit((int)*ptr2)) ptr2++;
-      isnum = 1;
-    } else {
-      while (*ptr1 && isalpha((int)*ptr1)) ptr1++;
-      while (*ptr2 && isalpha((int)*ptr2)) ptr2++;
-      isnum = 0;
-    }
-
-    /* save character at the end of the alpha or numeric segment */
-    /* so that they can be restored after the comparison */
-    oldch1 = *ptr1;
-    *ptr1 = '\0';
-    oldch2 = *ptr2;
-    *ptr2 = '\0';
-
-    /* this cannot happen, as we previously tested to make sure that */
-    /* the first string has a non-null segment */
-    if (one == ptr1) {
-      ret = -1;       /* arbitrary */
-      goto cleanup;
-    }
-
-    /* take care of the case where the two version segments are */
-    /* different types: one numeric, the other alpha (i.e. empty) */
-    /* numeric segments are always newer than alpha segments */
-    /* XXX See patch #60884 (and details) from bugzilla #50977. */
-    if (two == ptr2) {
-      ret = isnum ? 1 : -1;
-      goto cleanup;
-    }
-
-    if (isnum) {
-      /* this used to be done by converting the digit segments */
-      /* to ints using atoi() - it's changed because long  */
-      /* digit segments can overflow an int - this should fix that. */
-
-      /* throw away any leading zeros - it's a number, right? */
-      while (*one == '0') one++;
-      while (*two == '0') two++;
-
-      /* whichever number has more digits wins */
-      if (strlen(one) > strlen(two)) {
-        ret = 1;
-        goto cleanup;
-      }
-      if (strlen(two) > strlen(one)) {
-        ret = -1;
-        goto cleanup;
-      }
-    }
-
-    /* strcmp will return which one is greater - even if the two */
-    /* segments are alpha or if they are numeric.  don't return  */
-    /* if they are equal because there might be more segments to */
-    /* compare */
-    rc = strcmp(one, two);
-    if (rc) {
-      ret = rc < 1 ? -1 : 1;
-      goto cleanup;
-    }
-
-    /* restore character that was replaced by null above */
-    *ptr1 = oldch1;
-    one = ptr1;
-    *ptr2 = oldch2;
-    two = ptr2;
-  }
-
-  /* this catches the case where all numeric and alpha segments have */
-  /* compared identically but the segment separating characters were */
-  /* different */
-  if ((!*one) && (!*two)) {
-    ret = 0;
-    goto cleanup;
-  }
-
-  /* the final showdown. we never want a remaining alpha string to
-         * beat an empty string. the logic is a bit weird, but:
-         * - if one is empty and two is not an alpha, two is newer.
-         * - if one is an alpha, two is newer.
-         * - otherwise one is newer.
-         * */
-  if ( (!*one && !isalpha((int)*two))
-       || isalpha((int)*one) ) {
-    ret = -1;
-  } else {
-    ret = 1;
-  }
-
-cleanup:
-  free(str1);
-  free(str2);
-  return ret;
+ * TChar may be char (latin1) or ushort (utf16), characters beyond ascii are separators
+ */
+template <typename TChar>
+int rpmvercmpRange(const TChar* one, const TChar*const end1, const TChar* two, const TChar*const end2)
+{
+	/* easy comparison to see if versions are identical */
+	if (end1 - one == end2 - two && std::equal(one, end1, two)) return 0;
+
+	const TChar* ptr1 = one;
+	const TChar* ptr2 = two;
+
+	/* loop through each version segment of str1 and str2 and compare them */
+	while (one != end1 && two != end2) {
+		while (one != end1 && isAlnum(*one) == false) ++one;
+		while (two != end2 && isAlnum(*two) == false) ++two;
+
+		/* If we ran to the end of either, we are finished with the loop */
+		if (one == end1 || two == end2) break;
+
+		/* If the separator lengths were different, we are also finished */
+		if ((one - ptr1) != (two - ptr2)) {
+			return (one - ptr1) < (two - ptr2) ? -1 : 1;
+		}
+
+		ptr1 = one;
+		ptr2 = two;
+
+		/* grab first completely alpha or completely numeric segment */
+		bool isnum;
+		if (isDigit(*ptr1)) {
+			while (ptr1 != end1 && isDigit(*ptr1)) ++ptr1;
+			while (ptr2 != end2 && isDigit(*ptr2)) ++ptr2;
+			isnum = true;
+		} else {
+			while (ptr1 != end1 && isAlpha(*ptr1)) ++ptr1;
+			while (ptr2 != end2 && isAlpha(*ptr2)) ++ptr2;
+			isnum = false;
+		}
+
+		/* numeric segments are always newer than alpha segments */
+		if (two == ptr2) return isnum ? 1 : -1;
+
+		if (isnum) {
+			/* throw away any leading zeros - it's a number, right? */
+			while (one != ptr1 && *one == '0') ++one;
+			while (two != ptr2 && *two == '0') ++two;
+
+			/* whichever number has more digits wins */
+			if ((ptr1 - one) != (ptr2 - two)) {
+				return (ptr1 - one) > (ptr2 - two) ? 1 : -1;
+			}
+		}
+
+		/* don't return if they are equal because there might be more segments to compare */
+		const int rc = compareSegment(one, ptr1, two, ptr2);
+		if (rc != 0) return rc;
+
+		one = ptr1;
+		two = ptr2;
+	}
+
+	/* all segments compared identically but the separating characters were different */
+	if (one == end1 && two == end2) return 0;
+
+	/* the final showdown. we never want a remaining alpha string to beat an empty string */
+	if ((one == end1 && isAlpha(*two) == false) || (one != end1 && isAlpha(*one))) return -1;
+	return 1;
+}
+
+/**
+ * @brief epoch:version-release split of a package version (alpm parseEVR)
+ */
+template <typename TChar>
+struct EVR {
+	const TChar* epoch;
+	const TChar* epochEnd;
+	const TChar* version;
+	const TChar* versionEnd;
+	const TChar* release;    // nullptr if there is none
+	const TChar* releaseEnd;
+
+	EVR(const TChar*const begin, const TChar*const end) {
+		static const TChar ZERO[1] = { '0' };
+
+		const TChar* s = begin;
+		while (s != end && isDigit(*s)) ++s;
+
+		if (s != end && *s == ':') {
+			epoch    = begin;
+			epochEnd = s;
+			if (epoch == epochEnd) {
+				epoch    = ZERO;
+				epochEnd = ZERO + 1;
+			}
+			version = s + 1;
+		}
+		else {
+			epoch    = ZERO;
+			epochEnd = ZERO + 1;
+			version  = begin;
+		}
+
+		const TChar* se = end;
+		while (se != version && *(se - 1) != '-') --se;
+		if (se != version) {
+			versionEnd = se - 1;
+			release    = se;
+			releaseEnd = end;
+		}
+		else {
+			versionEnd = end;
+			release    = nullptr;
+			releaseEnd = nullptr;
+		}
+	}
+};
+
+/**
+ * @brief alpm_pkg_vercmp
+ */
+template <typename TChar>
+int vercmpRange(const TChar*const a, const TChar*const endA, const TChar*const b, const TChar*const endB)
+{
+	if (endA - a == endB - b && std::equal(a, endA, b)) return 0;
+
+	const EVR<TChar> one(a, endA);
+	const EVR<TChar> two(b, endB);
+
+	int ret = rpmvercmpRange(one.epoch, one.epochEnd, two.epoch, two.epochEnd);
+	if (ret == 0) {
+		ret = rpmvercmpRange(one.version, one.versionEnd, two.version, two.versionEnd);
+		if (ret == 0 && one.release != nullptr && two.release != nullptr) {
+			ret = rpmvercmpRange(one.release, one.releaseEnd, two.release, two.releaseEnd);
+		}
+	}
+	return ret;
+}
+
+/// tokens of a version key, see versionKey
+enum EVersionKeyToken {
+	eKeyComponentEnd = 0x00,
+	eKeyAlphaDirect  = 0x01, // alpha segment without leading separators: chars + 0x00
+	eKeyEnd          = 0x02, // end of the component
+	eKeySeparatorEnd = 0x03, // only separators left
+	eKeyDigitDirect  = 0x04, // numeric segment without leading separators: length (2 bytes) + digits
+	eKeySeparated    = 0x05  // separator count + type (alpha 0x01, digit 0x02) + segment as above
+};
+
+template <typename TChar>
+void appendSegment(QByteArray& key, const TChar* begin, const TChar*const end, const bool isnum)
+{
+	if (isnum) {
+		while (begin != end && *begin == '0') ++begin;
+		const int length = std::min<int>(end - begin, 0xFFFF);
+		key += static_cast<char>(length >> 8);
+		key += static_cast<char>(length & 0xFF);
+		for (int x = 0; x < length; ++x) key += static_cast<char>(begin[x]);
+	}
+	else {
+		for (; begin != end; ++begin) key += static_cast<char>(*begin);
+		key += static_cast<char>(eKeyComponentEnd);
+	}
+}
+
+/**
+ * @brief appends the key of one rpmvercmp component
+ */
+template <typename TChar>
+void appendComponentKey(QByteArray& key, const TChar* ptr, const TChar*const end)
+{
+	while (ptr != end) {
+		const TChar* segment = ptr;
+		while (segment != end && isAlnum(*segment) == false) ++segment;
+		if (segment == end) {
+			key += static_cast<char>(eKeySeparatorEnd);
+			return;
+		}
+
+		const bool isnum = isDigit(*segment);
+		const TChar* segmentEnd = segment;
+		while (segmentEnd != end && (isnum ? isDigit(*segmentEnd) : isAlpha(*segmentEnd))) ++segmentEnd;
+
+		if (segment == ptr) {
+			key += static_cast<char>(isnum ? eKeyDigitDirect : eKeyAlphaDirect);
+		}
+		else {
+			key += static_cast<char>(eKeySeparated);
+			key += static_cast<char>(std::min<int>(segment - ptr, 0xFF));
+			key += static_cast<char>(isnum ? 0x02 : 0x01);
+		}
+		appendSegment(key, segment, segmentEnd, isnum);
+		ptr = segmentEnd;
+	}
+	key += static_cast<char>(eKeyEnd);
+}
+
+}
+
+int rpmvercmp(const char* a, const char* b)
+{
+	return rpmvercmpRange(a, a + strlen(a), b, b + strlen(b));
+}
+
+int vercmp(const QString& a, const QString& b)
+{
+	const ushort*const one = a.utf16();
+	const ushort*const two = b.utf16();
+	return vercmpRange(one, one + a.size(), two, two + b.size());
+}
+
+/*
+ * The key is built from the same segments rpmvercmp visits, each one encoded
+ * so that memcmp orders it like rpmvercmp does. rpmvercmp is not transitive
+ * in one corner case (only separators left vs. a separated alpha segment,
+ * "1.0." vs "1.0.a"), there the key will order the trailing separators first.
+ * A missing release sorts before any release, vercmp would ignore it.
+ */
+QByteArray versionKey(const QString& version)
+{
+	const ushort*const begin = version.utf16();
+	const EVR<ushort> evr(begin, begin + version.size());
+
+	QByteArray key;
+	key.reserve(version.size() * 2 + 8);
+	appendComponentKey(key, evr.epoch, evr.epochEnd);
+	appendComponentKey(key, evr.version, evr.versionEnd);
+	if (evr.release != nullptr) appendComponentKey(key, evr.release, evr.releaseEnd);
+	else key += static_cast<char>(eKeyEnd);
+	return key;
 }
 
 }
@@ -21,7 +21,11 @@
 #ifndef PACMAN_H
 #define PACMAN_H
 
+#include <algorithm>
+#include <atomic>
+#include <cstring>
 #include <memory>
+#include <QByteArray>
 #include <QList>
 #include <QString>
 
@@ -36,10 +40,15 @@
  */
 namespace Pacman
 {
+	/**
+	 * @brief Package Information from the sync databases (fallback "-Ss")
+	 * @param localPackages (see getLocalPackages)
+	 */
+	std::unique_ptr<QList<PackageListData>>   getPackageList(const TLocalPackages& localPackages);
 	/**
 	 * @brief Package Information "-Ss"
 	 */
-	std::unique_ptr<QList<PackageListData>>   getPackageList();
+	std::unique_ptr<QList<PackageListData>>   getPackageListFromSearch();
 	/**
 	 * @brief Package Information "-Qm"
 	 */
@@ -47,19 +56,49 @@ namespace Pacman
 	/**
 	 * @brief Package Detail Information "-Si %pkgName" or "-Qi %pkgName" for installed
 	 * @param pkgName may be plain or (only for not-installed) in repo/name notation
+	 * @param stamp (database modification stamp of the last refresh, 0 will always run pacman)
+	 *
+	 * answered from the prefetched details if they were read for %stamp
 	 */
-	std::unique_ptr<QList<PackageDetailData>> getPackageDetails(const QString& pkgName, bool installedPackage = false);
+	std::unique_ptr<QList<PackageDetailData>> getPackageDetails(const QString& pkgName, bool installedPackage = false,
+	                                                            const qint64 stamp = 0);
 	/**
-	 * @brief List of all distinct package groups sorted by name "-Spg"
+	 * @brief Package Detail Information of all packages "-Si" and "-Qi", kept for getPackageDetails
+	 * @param stamp (database modification stamp of the last refresh)
+	 * @param cancelled (checked after each pacman call, nothing is kept once it is set)
+	 *
+	 * does nothing if the details were already read for %stamp
 	 */
-	std::unique_ptr<QStringList>   getPackageGroups();
-	std::unique_ptr<QStringList>   getPackageListForGroup(const QString& groupName);
+	void prefetchPackageDetails(const qint64 stamp, const std::atomic<bool>& cancelled);
+	/**
+	 * @brief Installation state of all installed packages from the local database (fallback "-Q", "-Qe", "-Qt")
+	 */
+	std::unique_ptr<TLocalPackages> getLocalPackages();
 	std::unique_ptr<QSet<QString>> getExplicitPackageList();
 	std::unique_ptr<QSet<QString>> getUnrequiredPackageList();
 	void synchronizeRepositories();
 
 	// Helper functions
+	/**
+	 * @brief compares two version segments like pacman, no allocations
+	 * @return 1: a is newer than b, 0: a and b are the same version, -1: b is newer than a
+	 */
 	int rpmvercmp(const char* a, const char* b);
+	/**
+	 * @brief compares two package versions ([epoch:]version[-release]) like "vercmp" of pacman
+	 * @return see rpmvercmp
+	 */
+	int vercmp(const QString& a, const QString& b);
+	/**
+	 * @brief sort key of a package version, compareVersionKeys orders the keys like vercmp (see pacman.cpp for exceptions)
+	 */
+	QByteArray versionKey(const QString& version);
+	inline int compareVersionKeys(const QByteArray& a, const QByteArray& b) {
+		// QByteArray::operator< stops at '\0'
+		const int cmp = memcmp(a.constData(), b.constData(), std::min(a.size(), b.size()));
+		if (cmp != 0) return cmp < 0 ? -1 : 1;
+		return a.size() < b.size() ? -1 : (a.size() > b.size() ? 1 : 0);
+	}
 	QString extractFieldFromInfo(const QString& field, const QString& pkgInfo);
 	QString getName(const QString& pkgInfo);
 	QString getDescription(const QString& pkgInfo);
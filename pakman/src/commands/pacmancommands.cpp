@@ -60,6 +60,42 @@ QByteArray PacmanCommands::performQuery(const bool asRoot, const QString &args,
 	return result;
 }
 
+/*
+ * Performs a pacman query and delivers stdout chunk by chunk while the process is still running
+ */
+void PacmanCommands::performStreamingQuery(const QString& args, const bool localized,
+                                           const std::function<void(const char*, int)>& consumer)
+{
+	QProcess pacman;
+
+	QProcessEnvironment env = QProcessEnvironment::systemEnvironment();
+	if (localized == false) {
+		env.insert("LANG", "C");
+		env.insert("LC_MESSAGES", "C");
+		env.insert("LC_ALL", "C");
+		pacman.setProcessEnvironment(env);
+	}
+	pacman.setReadChannel(QProcess::StandardOutput);
+	pacman.start("/bin/pacman " + args);
+	if (pacman.waitForStarted(-1) == false)
+		return;
+
+	char buffer[64 * 1024];
+	auto drain = [&]() {
+		qint64 size;
+		while ((size = pacman.read(buffer, sizeof(buffer))) > 0) {
+			consumer(buffer, size);
+		}
+	};
+	while (pacman.waitForReadyRead(-1)) {
+		drain();
+	}
+	pacman.waitForFinished(-1);
+	drain();
+
+	pacman.close();
+}
+
 /*
  * Returns a string with the list of all packages available in all repositories
  * (installed + not installed)
@@ -73,6 +109,15 @@ QByteArray PacmanCommands::getPackageList()
 	return result;
 }
 
+/*
+ * Streams the list of all packages available in all repositories (installed + not installed)
+ */
+void PacmanCommands::getPackageList(const std::function<void(const char*, int)>& consumer)
+{
+	QString args("-Ss");
+	performStreamingQuery(args, false, consumer);
+}
+
 /**
  * @brief returns a list of packages not found in the official repos
  */
@@ -104,24 +149,11 @@ QByteArray PacmanCommands::getPackageDetails(const QString& pkgName, bool instal
 }
 
 /*
- * Retrives the list of package groups
- *
- * from Octopi
- */
-QByteArray PacmanCommands::getPackageGroups()
-{
-	QString args("-Spg");
-	QByteArray res = performQuery(false, args, false, false);
-	return res;
-}
-
-/*
- * Retrives the list of package for a specific groups (name\nname...)
+ * Returns a string containing all installed packages (name version)
  */
-QByteArray PacmanCommands::getPackageListForGroup(const QString& groupName)
+QByteArray PacmanCommands::getInstalledPackageList()
 {
-	QString args("-Spg ");
-	args.append(groupName);
+	QString args("-Q");
 	QByteArray result = performQuery(false, args, false, false);
 	return result;
 }
@@ -21,6 +21,7 @@
 #ifndef PACMANCOMMANDS_H
 #define PACMANCOMMANDS_H
 
+#include <functional>
 #include <QByteArray>
 
 
@@ -45,10 +46,25 @@ public:
 	static QByteArray performQuery(const bool asRoot, const QString& args,
 	                               const bool localized, const bool fallbackToStderr);
 
+	/**
+	 * @brief will execute pacman (as current user) with $args and hand stdout to %consumer while pacman is running
+	 * @param args e.g "-Ss"
+	 * @param localized (if false the query will be executed with LANG C etc.)
+	 * @param consumer will be called for each chunk of raw stdout data (data, length)
+	 *
+	 * only one chunk is buffered at a time
+	 */
+	static void performStreamingQuery(const QString& args, const bool localized,
+	                                  const std::function<void(const char*, int)>& consumer);
+
 	/**
 	 * @brief Repo-PackageList "-Ss"
 	 */
 	static QByteArray getPackageList();
+	/**
+	 * @brief Repo-PackageList "-Ss" (streamed, see performStreamingQuery)
+	 */
+	static void getPackageList(const std::function<void(const char*, int)>& consumer);
 	/**
 	 * @brief Repo-PackageList "-Qm"
 	 */
@@ -58,13 +74,9 @@ public:
 	 */
 	static QByteArray getPackageDetails(const QString& pkgName, bool installedPackage = false);
 	/**
-	 * @brief Repo-PackageGroups "-Spg"
-	 */
-	static QByteArray getPackageGroups();
-	/**
-	 * @brief PackageGroup-Members "-Spg %group"
+	 * @brief InstalledPackageList "-Q" (name version)
 	 */
-	static QByteArray getPackageListForGroup(const QString& groupName);
+	static QByteArray getInstalledPackageList();
 	/**
 	 * @brief ExplicitlyInstalledPackageList "-Qe" (not as dependency)
 	 */
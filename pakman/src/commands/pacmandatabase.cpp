@@ -0,0 +1,575 @@
+/*
+* This file is part of pakman, an open-source GUI for pacman.
+* Copyright (C) 2014 Thomas Binkau
+*
+* This program is free software; you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation; either version 2 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+*
+*/
+
+#include "pacmandatabase.h"
+
+#include <cstring>
+#include <iostream>
+#include <archive.h>
+#include <archive_entry.h>
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QTextStream>
+#include <QSet>
+#include <QtConcurrentMap>
+
+#include "src/strconstants.h"
+#include "src/data/fileownershipindex.h"
+
+
+namespace PacmanDatabase {
+
+namespace {
+
+/**
+ * @brief calls fnc(key, keyLength, value, valueLength) for each line of each %KEY% block of a desc file
+ *
+ * desc format:
+ * %NAME%
+ * foo
+ *
+ * %GROUPS%
+ * bar
+ * baz
+ */
+template<class TFunc>
+void forEachDescValue(const char* data, const char* const end, TFunc fnc)
+{
+	const char* key = nullptr;
+	int keyLength = 0;
+	while (data < end) {
+		const char* eol = static_cast<const char*>(memchr(data, '\n', end - data));
+		if (eol == nullptr) eol = end;
+		const int length = eol - data;
+
+		if (length == 0) {
+			key = nullptr; // end of block
+		}
+		else if (key == nullptr) {
+			if (length > 2 && data[0] == '%' && data[length - 1] == '%') {
+				key = data + 1;
+				keyLength = length - 2;
+			}
+		}
+		else fnc(key, keyLength, data, length);
+
+		data = eol + 1;
+	}
+}
+
+inline bool keyEquals(const char* key, const int keyLength, const char* expected, const int expectedLength)
+{
+	return keyLength == expectedLength && memcmp(key, expected, keyLength) == 0;
+}
+
+/**
+ * @brief appends the package described by desc (sync db format, including the depends entry of pacman < 4.2) to result
+ */
+void appendSyncPackage(const QByteArray& desc, const QString& repository,
+                       const TLocalPackages& installed, QList<PackageListData>& result)
+{
+	QString name, version, description;
+	QStringList groups, depends, provides;
+	forEachDescValue(desc.constData(), desc.constData() + desc.size(),
+	                 [&](const char* key, int keyLength, const char* value, int length) {
+		if (keyEquals(key, keyLength, "NAME", 4))
+			name = QString::fromUtf8(value, length);
+		else if (keyEquals(key, keyLength, "VERSION", 7))
+			version = QString::fromUtf8(value, length);
+		else if (keyEquals(key, keyLength, "DESC", 4))
+			description = QString::fromUtf8(value, length);
+		else if (keyEquals(key, keyLength, "GROUPS", 6))
+			groups << QString::fromUtf8(value, length);
+		else if (keyEquals(key, keyLength, "DEPENDS", 7))
+			depends << QString::fromUtf8(value, length);
+		else if (keyEquals(key, keyLength, "PROVIDES", 8))
+			provides << QString::fromUtf8(value, length);
+	});
+	if (name.isEmpty())
+		return;
+
+	PackageStatus status = epkg_NON_INSTALLED;
+	QString outdatedVersion;
+	TLocalPackages::const_iterator it = installed.find(name);
+	if (it != installed.end()) {
+		if (it->version == version) {
+			status = epkg_INSTALLED;
+		}
+		else {
+			status = epkg_OUTDATED;
+			outdatedVersion = it->version;
+		}
+	}
+	// same description layout as the "-Ss" parser
+	result.append(PackageListData(name, repository, version, name + " " + description, status, outdatedVersion));
+	result.last().groups   = groups;
+	result.last().depends  = depends;
+	result.last().provides = provides;
+}
+
+/**
+ * @brief reads one sync database (one repository), used as functor for QtConcurrent::blockingMapped
+ */
+struct ReadSyncDatabase {
+	typedef std::shared_ptr<QList<PackageListData>> result_type;
+
+	ReadSyncDatabase(const QString& dbPath, const TLocalPackages& localPackages)
+	  : path(dbPath), installed(localPackages)
+	{}
+
+	/**
+	 * @return nullptr on error
+	 */
+	result_type operator()(const QString& repository) const {
+		const QByteArray file = QFile::encodeName(path + "sync/" + repository + ".db");
+		result_type result(new QList<PackageListData>());
+
+		struct archive*const archive = archive_read_new();
+		archive_read_support_filter_all(archive);
+		archive_read_support_format_all(archive);
+		if (archive_read_open_filename(archive, file.constData(), 128 * 1024) != ARCHIVE_OK) {
+			std::cerr << strAppName() << " " << strErrorCanNotReadDatabase().toStdString() << " "
+			          << file.constData() << ": " << archive_error_string(archive) << std::endl;
+			archive_read_free(archive);
+			return result_type();
+		}
+
+		// desc and depends (pacman < 4.2) of one %pkgname-%version directory, both use the %KEY% block format
+		QByteArray desc;
+		QByteArray directory;
+		struct archive_entry* entry;
+		int rc;
+		while ((rc = archive_read_next_header(archive, &entry)) == ARCHIVE_OK) {
+			// only %pkgname-%version/desc and %pkgname-%version/depends entries are relevant
+			const char*const entryPath = archive_entry_pathname(entry);
+			const char*const fileName = strrchr(entryPath, '/');
+			if (fileName == nullptr || (strcmp(fileName, "/desc") != 0 && strcmp(fileName, "/depends") != 0)) {
+				archive_read_data_skip(archive);
+				continue;
+			}
+
+			// the entries of a directory follow each other
+			const QByteArray entryDirectory(entryPath, fileName - entryPath);
+			if (entryDirectory != directory) {
+				if (desc.isEmpty() == false) appendSyncPackage(desc, repository, installed, *result);
+				desc.clear();
+				directory = entryDirectory;
+			}
+
+			const int start = desc.size();
+			desc.resize(start + archive_entry_size(entry));
+			int pos = start;
+			while (pos < desc.size()) {
+				const ssize_t read = archive_read_data(archive, desc.data() + pos, desc.size() - pos);
+				if (read <= 0) break;
+				pos += read;
+			}
+			desc.resize(pos);
+			desc.append('\n'); // ends the last block of the entry
+		}
+		if (desc.isEmpty() == false) appendSyncPackage(desc, repository, installed, *result);
+		if (rc != ARCHIVE_EOF) {
+			std::cerr << strAppName() << " " << strErrorCanNotReadDatabase().toStdString() << " "
+			          << file.constData() << ": " << archive_error_string(archive) << std::endl;
+			result.reset();
+		}
+
+		archive_read_free(archive);
+		return result;
+	}
+
+	const QString         path;
+	const TLocalPackages& installed;
+};
+
+/**
+ * @brief dependency name without version restriction or description ("foo>=1.0", "foo: for bar")
+ */
+inline QString dependencyName(const char* value, const int length)
+{
+	int x = 0;
+	while (x < length && value[x] != '<' && value[x] != '>' && value[x] != '=' && value[x] != ':') ++x;
+	return QString::fromUtf8(value, x);
+}
+
+/**
+ * @brief contents of one local desc file
+ */
+struct LocalDesc {
+	QString          name;
+	LocalPackageData data;
+	QStringList      provides;     // names only
+	QStringList      dependencies; // names only, depends + optdepends
+};
+
+/**
+ * @brief reads the desc file of one installed package, used as functor for QtConcurrent::blockingMapped
+ */
+struct ReadLocalDesc {
+	typedef LocalDesc result_type;
+
+	ReadLocalDesc(const QString& localPath)
+	  : path(localPath)
+	{}
+
+	result_type operator()(const QString& entry) const {
+		LocalDesc result;
+		QFile file(path + entry + "/desc");
+		if (file.open(QIODevice::ReadOnly) == false || file.size() == 0)
+			return result;
+
+		const char*const data = reinterpret_cast<const char*>(file.map(0, file.size()));
+		if (data == nullptr)
+			return result;
+
+		result.data.explicitlyInstalled = true; // %REASON% is omitted for explicitly installed packages
+		forEachDescValue(data, data + file.size(), [&](const char* key, int keyLength, const char* value, int length) {
+			if (keyEquals(key, keyLength, "NAME", 4))
+				result.name = QString::fromUtf8(value, length);
+			else if (keyEquals(key, keyLength, "VERSION", 7))
+				result.data.version = QString::fromUtf8(value, length);
+			else if (keyEquals(key, keyLength, "REASON", 6))
+				result.data.explicitlyInstalled = (length != 1 || value[0] != '1');
+			else if (keyEquals(key, keyLength, "DEPENDS", 7) || keyEquals(key, keyLength, "OPTDEPENDS", 10))
+				result.dependencies << dependencyName(value, length);
+			else if (keyEquals(key, keyLength, "PROVIDES", 8))
+				result.provides << dependencyName(value, length);
+		});
+		file.close();
+		return result;
+	}
+
+	const QString path;
+};
+
+/**
+ * @brief database entries are named %NAME%-%VERSION%, the version (pkgver-pkgrel) contains exactly one '-'
+ */
+bool splitEntryName(const QString& entry, QString& name, QString& version)
+{
+	const int versionStart = entry.lastIndexOf('-', entry.lastIndexOf('-') - 1);
+	if (versionStart <= 0)
+		return false;
+	name    = entry.left(versionStart);
+	version = entry.mid(versionStart + 1);
+	return true;
+}
+
+/**
+ * @brief streams the files lists of one sync .files database into %index
+ * @return false if the database could not be read
+ */
+bool appendSyncFiles(const QString& dbPath, const QString& repository, FileOwnershipIndex& index)
+{
+	const QByteArray file = QFile::encodeName(dbPath + "sync/" + repository + ".files");
+	struct archive*const archive = archive_read_new();
+	archive_read_support_filter_all(archive);
+	archive_read_support_format_all(archive);
+	if (archive_read_open_filename(archive, file.constData(), 128 * 1024) != ARCHIVE_OK) {
+		std::cerr << strAppName() << " " << strErrorCanNotReadDatabase().toStdString() << " "
+		          << file.constData() << ": " << archive_error_string(archive) << std::endl;
+		archive_read_free(archive);
+		return false;
+	}
+
+	QByteArray files;
+	QString name, version;
+	struct archive_entry* entry;
+	int rc;
+	while ((rc = archive_read_next_header(archive, &entry)) == ARCHIVE_OK) {
+		// only %pkgname-%version/files entries are relevant
+		const char*const entryPath = archive_entry_pathname(entry);
+		const std::size_t entryPathLength = strlen(entryPath);
+		if (entryPathLength < 6 || strcmp(entryPath + entryPathLength - 6, "/files") != 0 ||
+		    splitEntryName(QString::fromUtf8(entryPath, entryPathLength - 6), name, version) == false) {
+			archive_read_data_skip(archive);
+			continue;
+		}
+
+		files.resize(archive_entry_size(entry));
+		int pos = 0;
+		while (pos < files.size()) {
+			const ssize_t read = archive_read_data(archive, files.data() + pos, files.size() - pos);
+			if (read <= 0) break;
+			pos += read;
+		}
+		const quint32 owner = index.addPackage(repository, name, version);
+		forEachDescValue(files.constData(), files.constData() + pos,
+		                 [&](const char* key, int keyLength, const char* value, int length) {
+			if (keyEquals(key, keyLength, "FILES", 5))
+				index.addPath(owner, value, length);
+		});
+	}
+	if (rc != ARCHIVE_EOF) {
+		std::cerr << strAppName() << " " << strErrorCanNotReadDatabase().toStdString() << " "
+		          << file.constData() << ": " << archive_error_string(archive) << std::endl;
+	}
+
+	archive_read_free(archive);
+	return rc == ARCHIVE_EOF;
+}
+
+/**
+ * @brief contents of one local files file
+ */
+struct LocalFiles {
+	QString    name;
+	QString    version;
+	QByteArray files;
+};
+
+/**
+ * @brief reads the files list of one installed package, used as functor for QtConcurrent::blockingMapped
+ */
+struct ReadLocalFiles {
+	typedef LocalFiles result_type;
+
+	ReadLocalFiles(const QString& localPath)
+	  : path(localPath)
+	{}
+
+	result_type operator()(const QString& entry) const {
+		LocalFiles result;
+		QFile file(path + entry + "/files");
+		if (splitEntryName(entry, result.name, result.version) == false || file.open(QIODevice::ReadOnly) == false)
+			return LocalFiles();
+		result.files = file.readAll();
+		file.close();
+		return result;
+	}
+
+	const QString path;
+};
+
+} // anonymous namespace
+
+
+Configuration getConfiguration()
+{
+	Configuration config;
+	config.dbPath = strPacmanDatabaseDir();
+
+	QFile file(strPacmanConfig());
+	if (file.open(QIODevice::ReadOnly | QIODevice::Text) == false)
+		return config;
+
+	QTextStream in(&file);
+	QString section;
+	while (in.atEnd() == false) {
+		const QString line = in.readLine().section('#', 0, 0).trimmed();
+		if (line.isEmpty())
+			continue;
+
+		if (line.startsWith('[') && line.endsWith(']')) {
+			section = line.mid(1, line.size() - 2).trimmed();
+			if (section != "options" && config.repositories.contains(section) == false)
+				config.repositories << section;
+		}
+		else if (section == "options" && line.section('=', 0, 0).trimmed() == "DBPath") {
+			QString path = line.section('=', 1).trimmed();
+			if (path.isEmpty() == false) {
+				if (path.endsWith('/') == false) path += '/';
+				config.dbPath = path;
+			}
+		}
+	}
+	file.close();
+	return config;
+}
+
+bool isLocalAvailable(const Configuration& config)
+{
+	return QFileInfo(config.dbPath + "local").isReadable();
+}
+
+qint64 getModificationStamp(const Configuration& config)
+{
+	// the local directory gets a new entry for every installed or upgraded package, "-D --asdeps/--asexplicit"
+	// and reinstalls of the same version rewrite the desc file of the package in place
+	QStringList files(config.dbPath + "local");
+	const QDir local(config.dbPath + "local");
+	foreach (const QString& entry, local.entryList(QDir::Dirs | QDir::NoDotAndDotDot, QDir::Name)) {
+		files.append(local.filePath(entry) + "/desc");
+	}
+	foreach (const QString& repository, config.repositories) {
+		files.append(config.dbPath + "sync/" + repository + ".db");
+	}
+
+	quint64 stamp = 0; // wraps around
+	foreach (const QString& file, files) {
+		const QFileInfo info(file);
+		if (info.exists() == false) continue;
+		// mtimes of synchronized databases are set by the mirror and may go backwards, combine them all
+		stamp = stamp * 31 + info.lastModified().toMSecsSinceEpoch();
+	}
+	return static_cast<qint64>(stamp);
+}
+
+qint64 getSyncFilesModificationStamp(const Configuration& config)
+{
+	qint64 stamp = 0;
+	foreach (const QString& repository, config.repositories) {
+		const QFileInfo info(config.dbPath + "sync/" + repository + ".files");
+		if (info.exists() == false) continue;
+		stamp = stamp * 31 + info.lastModified().toMSecsSinceEpoch();
+	}
+	return stamp;
+}
+
+bool isAvailable(const Configuration& config)
+{
+	if (config.repositories.isEmpty())
+		return false;
+
+	foreach (const QString& repository, config.repositories) {
+		if (QFileInfo(config.dbPath + "sync/" + repository + ".db").isReadable() == false)
+			return false;
+	}
+	return true;
+}
+
+bool isSyncFilesAvailable(const Configuration& config)
+{
+	if (config.repositories.isEmpty())
+		return false;
+
+	foreach (const QString& repository, config.repositories) {
+		if (QFileInfo(config.dbPath + "sync/" + repository + ".files").isReadable() == false)
+			return false;
+	}
+	return true;
+}
+
+/*
+ * Reads all sync databases in parallel (one repository per thread), the
+ * result is ordered like the output of "-Ss" (repositories as in pacman.conf)
+ */
+std::unique_ptr<QList<PackageListData>> getPackageList(const Configuration& config,
+                                                       const TLocalPackages& localPackages)
+{
+	const QList<ReadSyncDatabase::result_type> repositories =
+	    QtConcurrent::blockingMapped<QList<ReadSyncDatabase::result_type>>(config.repositories,
+	                                                                       ReadSyncDatabase(config.dbPath, localPackages));
+
+	int size = 0;
+	foreach (const ReadSyncDatabase::result_type& list, repositories) {
+		if (list == nullptr)
+			return std::unique_ptr<QList<PackageListData>>();
+		size += list->size();
+	}
+
+	QList<PackageListData>*const res = new QList<PackageListData>();
+	res->reserve(size);
+	foreach (const ReadSyncDatabase::result_type& list, repositories) {
+		res->append(*list);
+	}
+	return std::unique_ptr<QList<PackageListData>>(res);
+}
+
+/*
+ * Reads all desc files of the local database (in parallel, memory mapped) and
+ * derives the "required" state the way "-Qt" does: a package is required if
+ * another installed package depends on it or on something it provides, or
+ * lists it as optional dependency
+ */
+std::unique_ptr<TLocalPackages> getLocalPackages(const Configuration& config)
+{
+	const QString path(config.dbPath + "local/");
+	const QStringList entries = QDir(path).entryList(QDir::Dirs | QDir::NoDotAndDotDot);
+	const QList<LocalDesc> descs = QtConcurrent::blockingMapped<QList<LocalDesc>>(entries, ReadLocalDesc(path));
+
+	TLocalPackages*const res = new TLocalPackages();
+	res->reserve(descs.size());
+	QHash<QString, QStringList> providers; // provided name -> package names
+	providers.reserve(descs.size());
+	QSet<QString> required;
+	foreach (const LocalDesc& desc, descs) {
+		if (desc.name.isEmpty())
+			continue;
+
+		res->insert(desc.name, desc.data);
+		providers[desc.name] << desc.name;
+		foreach (const QString& provided, desc.provides) {
+			providers[provided] << desc.name;
+		}
+		foreach (const QString& dependency, desc.dependencies) {
+			required.insert(dependency);
+		}
+	}
+
+	foreach (const QString& dependency, required) {
+		QHash<QString, QStringList>::const_iterator it = providers.find(dependency);
+		if (it == providers.end())
+			continue;
+		foreach (const QString& name, *it) {
+			(*res)[name].required = true;
+		}
+	}
+	return std::unique_ptr<TLocalPackages>(res);
+}
+
+/*
+ * Reads the files lists of the local database in parallel, the index itself
+ * is built in the calling thread afterwards (directories shared by all packages)
+ */
+std::unique_ptr<FileOwnershipIndex> getFileOwnershipIndex(const Configuration& config)
+{
+	const QString path(config.dbPath + "local/");
+	if (QFileInfo(path).isReadable() == false)
+		return std::unique_ptr<FileOwnershipIndex>();
+
+	const QStringList entries = QDir(path).entryList(QDir::Dirs | QDir::NoDotAndDotDot);
+	const QList<LocalFiles> packages = QtConcurrent::blockingMapped<QList<LocalFiles>>(entries, ReadLocalFiles(path));
+
+	FileOwnershipIndex*const res = new FileOwnershipIndex();
+	foreach (const LocalFiles& package, packages) {
+		if (package.name.isEmpty())
+			continue;
+
+		const quint32 owner = res->addPackage(QString(), package.name, package.version);
+		const QByteArray& files = package.files;
+		forEachDescValue(files.constData(), files.constData() + files.size(),
+		                 [&](const char* key, int keyLength, const char* value, int length) {
+			if (keyEquals(key, keyLength, "FILES", 5))
+				res->addPath(owner, value, length);
+		});
+	}
+	res->finish(false);
+	return std::unique_ptr<FileOwnershipIndex>(res);
+}
+
+/*
+ * The .files databases are streamed one after another (extracting them is the
+ * expensive part, a single index is filled), base names get a trigram index
+ */
+std::unique_ptr<FileOwnershipIndex> getSyncFilesIndex(const Configuration& config)
+{
+	std::unique_ptr<FileOwnershipIndex> res(new FileOwnershipIndex());
+	foreach (const QString& repository, config.repositories) {
+		if (appendSyncFiles(config.dbPath, repository, *res) == false)
+			return std::unique_ptr<FileOwnershipIndex>();
+	}
+	res->finish(true);
+	return res;
+}
+
+}
@@ -0,0 +1,106 @@
+/*
+* This file is part of pakman, an open-source GUI for pacman.
+* Copyright (C) 2014 Thomas Binkau
+*
+* This program is free software; you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation; either version 2 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+*
+*/
+
+#ifndef PACMANDATABASE_H
+#define PACMANDATABASE_H
+
+#include <memory>
+#include <QList>
+#include <QHash>
+#include <QString>
+#include <QStringList>
+
+#include "src/data/packagedata.h"
+
+class FileOwnershipIndex;
+
+
+/**
+ * @brief direct (read only) access to the pacman databases, no pacman process involved
+ *
+ * delivers the same parsed data as the corresponding functions in pacman.h
+ */
+namespace PacmanDatabase
+{
+	/**
+	 * @brief Database path and sync repositories (in order of precedence) as configured in pacman.conf
+	 */
+	struct Configuration {
+		QString     dbPath;       // with trailing separator
+		QStringList repositories;
+	};
+
+	/**
+	 * @brief reads pacman.conf, will default to the standard database path
+	 */
+	Configuration getConfiguration();
+	/**
+	 * @brief true if all configured sync databases are readable
+	 */
+	bool isAvailable(const Configuration& config);
+	/**
+	 * @brief true if the local database is readable
+	 */
+	bool isLocalAvailable(const Configuration& config);
+	/**
+	 * @brief combined modification time of the local database (including every desc file) and all sync databases
+	 *
+	 * changes with every install, reinstall, removal, change of the install reason or database synchronization,
+	 * 0 if nothing is readable
+	 */
+	qint64 getModificationStamp(const Configuration& config);
+	/**
+	 * @brief combined modification time of the .files databases, changes with every "-Fy"
+	 */
+	qint64 getSyncFilesModificationStamp(const Configuration& config);
+	/**
+	 * @brief Package Information of all sync databases, same result as Pacman::getPackageList ("-Ss")
+	 * @param localPackages (see getLocalPackages)
+	 * @return nullptr if one of the databases could not be read
+	 *
+	 * every repository will be read in its own thread
+	 */
+	std::unique_ptr<QList<PackageListData>> getPackageList(const Configuration& config,
+	                                                       const TLocalPackages& localPackages);
+	/**
+	 * @brief Version, install reason and required state of all installed packages ("-Q", "-Qe", "-Qt")
+	 *
+	 * the desc files are read in parallel
+	 */
+	std::unique_ptr<TLocalPackages> getLocalPackages(const Configuration& config);
+	/**
+	 * @brief Owners of all files of the installed packages, answers "-Qo" without a pacman process
+	 * @return nullptr if the local database could not be read
+	 *
+	 * the files lists are read in parallel
+	 */
+	std::unique_ptr<FileOwnershipIndex> getFileOwnershipIndex(const Configuration& config);
+	/**
+	 * @brief true if the .files databases of all configured repositories are readable ("-Fy" has been run)
+	 */
+	bool isSyncFilesAvailable(const Configuration& config);
+	/**
+	 * @brief Files of all packages in the sync databases (sync/ *.files), answers "-F" without a pacman process
+	 * @return nullptr if one of the databases could not be read
+	 */
+	std::unique_ptr<FileOwnershipIndex> getSyncFilesIndex(const Configuration& config);
+};
+
+#endif // PACMANDATABASE_H
@@ -48,13 +48,14 @@ public:
 		eTaskFetchPackageListForeign,
 		eTaskSynchronizeRepo,
 		eTaskPacman,
+		eTaskStoreSnapshot,
 		eTaskUpdateDistributionNews,
-		eTaskUpdateGroupList,
-		eTaskUpdateGroupMembers,
+		eTaskUpdateFileOwnership,
 		eTaskUpdatePackageInfoTab,
 		eTaskUpdatePackageList,
 		eTaskUpdatePackageListForeign,
-		eTaskUpdateReportInfoTab
+		eTaskUpdateReportInfoTab,
+		eTaskUpdateSyncFiles
 	};
 	enum ETaskInsertMode {
 		OnlyOne,                   // There may be only one task of that type queued (or running)
@@ -0,0 +1,113 @@
+/*
+* This file is part of pakman, an open-source GUI for pacman.
+* Copyright (C) 2014 Thomas Binkau
+*
+* This program is free software; you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation; either version 2 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+*
+*/
+
+#include "dependencygraph.h"
+
+#include <algorithm>
+#include <cassert>
+
+#include "src/commands/pacman.h"
+#include "src/data/packagestore.h"
+#include "src/data/providesindex.h"
+
+
+//////// DependencyGraph::Relation //////////////////////////////
+
+DependencyGraph::Relation DependencyGraph::Relation::parse(const QString& relation)
+{
+	Relation result;
+	result.constraint = eAny;
+
+	int x = 0;
+	const int length = relation.size();
+	while (x < length && relation[x] != '<' && relation[x] != '>' && relation[x] != '=') ++x;
+	result.name = relation.left(x);
+	if (x == length)
+		return result;
+
+	const QChar op = relation[x];
+	const bool orEqual = op != '=' && x + 1 < length && relation[x + 1] == '=';
+	if (op == '=')      result.constraint = eEqual;
+	else if (op == '<') result.constraint = orEqual ? eLessEqual : eLess;
+	else                result.constraint = orEqual ? eGreaterEqual : eGreater;
+	result.version = relation.mid(x + (orEqual ? 2 : 1));
+	return result;
+}
+
+bool DependencyGraph::Relation::isSatisfiedBy(const QString& packageVersion) const
+{
+	if (constraint == eAny)
+		return true;
+
+	const int cmp = Pacman::vercmp(packageVersion, version);
+	switch (constraint) {
+	case eLess:         return cmp < 0;
+	case eLessEqual:    return cmp <= 0;
+	case eEqual:        return cmp == 0;
+	case eGreaterEqual: return cmp >= 0;
+	case eGreater:      return cmp > 0;
+	default:            return true;
+	}
+}
+
+//////// DependencyGraph //////////////////////////////
+
+DependencyGraph::DependencyGraph()
+	: m_dependsOffset(1, 0), m_requiredByOffset(1, 0)
+{
+}
+
+void DependencyGraph::reset(const PackageStore& store, const ProvidesIndex& provides)
+{
+	assert(provides.getGeneration() == store.getGeneration());
+	const quint32 count = store.size();
+
+	// forward edges
+	m_dependsOffset.resize(count + 1);
+	m_dependsIds.clear();
+	m_dependsOffset[0] = 0;
+	for (quint32 id = 0; id < count; ++id) {
+		const std::size_t first = m_dependsIds.size();
+		foreach (const QString& depends, store.package(id)->depends) {
+			const quint32 target = provides.resolve(Relation::parse(depends));
+			if (target == ProvidesIndex::NO_PACKAGE)
+				continue;
+			if (target != id && std::find(m_dependsIds.begin() + first, m_dependsIds.end(), target) == m_dependsIds.end())
+				m_dependsIds.push_back(target);
+		}
+		m_dependsOffset[id + 1] = m_dependsIds.size();
+	}
+
+	// reverse edges (counting sort keeps them ordered by id)
+	m_requiredByOffset.assign(count + 1, 0);
+	for (std::vector<quint32>::const_iterator it = m_dependsIds.begin(); it != m_dependsIds.end(); ++it) {
+		++m_requiredByOffset[*it + 1];
+	}
+	for (quint32 id = 0; id < count; ++id) {
+		m_requiredByOffset[id + 1] += m_requiredByOffset[id];
+	}
+	m_requiredByIds.resize(m_dependsIds.size());
+	std::vector<quint32> next(m_requiredByOffset.begin(), m_requiredByOffset.end() - 1);
+	for (quint32 id = 0; id < count; ++id) {
+		for (quint32 x = m_dependsOffset[id]; x < m_dependsOffset[id + 1]; ++x) {
+			m_requiredByIds[next[m_dependsIds[x]]++] = id;
+		}
+	}
+}
@@ -0,0 +1,97 @@
+/*
+* This file is part of pakman, an open-source GUI for pacman.
+* Copyright (C) 2014 Thomas Binkau
+*
+* This program is free software; you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation; either version 2 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+*
+*/
+
+#ifndef DEPENDENCYGRAPH_H
+#define DEPENDENCYGRAPH_H
+
+#include <utility>
+#include <vector>
+#include <QString>
+
+class PackageStore;
+class ProvidesIndex;
+
+
+/**
+ * @brief Dependencies between the packages of a PackageStore in compressed sparse row format
+ *
+ * Every dependency ("foo>=1.0") is resolved once to a single package id by the ProvidesIndex:
+ * a package called foo that satisfies the version restriction, otherwise the preferred provider.
+ * Both directions (depends on / required by) are stored as one id array plus offsets per package.
+ */
+class DependencyGraph
+{
+public:
+	typedef std::pair<const quint32*, const quint32*> TIdRange; // [first, second)
+
+	enum EConstraint {
+		eAny,          // foo
+		eLess,         // foo<1.0
+		eLessEqual,    // foo<=1.0
+		eEqual,        // foo=1.0
+		eGreaterEqual, // foo>=1.0
+		eGreater       // foo>1.0
+	};
+
+	/**
+	 * @brief parsed dependency or provision like "foo>=1.0"
+	 */
+	struct Relation {
+		QString     name;
+		EConstraint constraint;
+		QString     version;
+
+		static Relation parse(const QString& relation);
+		/**
+		 * @brief true if a package of %version fulfills the constraint
+		 */
+		bool isSatisfiedBy(const QString& version) const;
+	};
+
+public:
+	DependencyGraph();
+
+	/**
+	 * @brief rebuilds the graph from the depends of all packages in %store
+	 * @param provides must have been built for the same generation of %store
+	 */
+	void reset(const PackageStore& store, const ProvidesIndex& provides);
+
+	inline TIdRange getDependsOn(const quint32 id) const {
+		return range(m_dependsOffset, m_dependsIds, id);
+	}
+	inline TIdRange getRequiredBy(const quint32 id) const {
+		return range(m_requiredByOffset, m_requiredByIds, id);
+	}
+
+private:
+	static inline TIdRange range(const std::vector<quint32>& offsets, const std::vector<quint32>& ids,
+	                             const quint32 id) {
+		return TIdRange(ids.data() + offsets[id], ids.data() + offsets[id + 1]);
+	}
+
+private:
+	std::vector<quint32> m_dependsOffset;    // size + 1 entries
+	std::vector<quint32> m_dependsIds;
+	std::vector<quint32> m_requiredByOffset; // size + 1 entries
+	std::vector<quint32> m_requiredByIds;
+};
+
+#endif // DEPENDENCYGRAPH_H
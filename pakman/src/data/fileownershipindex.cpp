@@ -0,0 +1,212 @@
+/*
+* This file is part of pakman, an open-source GUI for pacman.
+* Copyright (C) 2014 Thomas Binkau
+*
+* This program is free software; you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation; either version 2 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+*
+*/
+
+#include "fileownershipindex.h"
+
+#include <algorithm>
+#include <cassert>
+
+
+namespace {
+
+/**
+ * @brief length of the directory part of %path including its slash ("usr/bin/" of "usr/bin/ls" and "usr/bin/foo/")
+ */
+inline int directoryLength(const char* path, int length)
+{
+	if (length > 0 && path[length - 1] == '/') --length; // a directory is a member of its parent
+	while (length > 0 && path[length - 1] != '/') --length;
+	return length;
+}
+
+/**
+ * @return id of %key, a new id (number of keys) is assigned to unknown keys
+ */
+inline quint32 intern(QHash<QByteArray, quint32>& ids, const QByteArray& key, bool& added)
+{
+	QHash<QByteArray, quint32>::const_iterator it = ids.find(key);
+	added = it == ids.end();
+	if (added)
+		it = ids.insert(key, ids.size());
+	return *it;
+}
+
+}
+
+
+FileOwnershipIndex::FileOwnershipIndex()
+	: m_nameOffsets(1, 0)
+{
+}
+
+quint32 FileOwnershipIndex::addPackage(const QString& repository, const QString& name, const QString& version)
+{
+	Owner owner;
+	owner.repository = repository;
+	owner.name       = name;
+	owner.version    = version;
+	m_owners.push_back(owner);
+	return m_owners.size() - 1;
+}
+
+void FileOwnershipIndex::addPath(const quint32 owner, const char* path, const int length)
+{
+	assert(owner < m_owners.size());
+	const int dirLength = directoryLength(path, length);
+	bool added;
+
+	Entry entry;
+	entry.directory = intern(m_directories, QByteArray(path, dirLength), added);
+	entry.name      = intern(m_nameIds, QByteArray(path + dirLength, length - dirLength), added);
+	entry.owner     = owner;
+	if (added) {
+		m_names.append(path + dirLength, length - dirLength);
+		m_nameOffsets.push_back(m_names.size());
+	}
+	m_entries.push_back(entry);
+}
+
+void FileOwnershipIndex::finish(const bool searchable)
+{
+	std::sort(m_entries.begin(), m_entries.end());
+	m_names.squeeze();
+	m_directories.squeeze();
+	m_nameIds.squeeze();
+
+	// owners by name id (counting pass, the owners of each name are deduplicated afterwards)
+	const quint32 nameCount = m_nameOffsets.size() - 1;
+	std::vector<quint32> offsets(nameCount + 1, 0);
+	for (std::vector<Entry>::const_iterator it = m_entries.begin(); it != m_entries.end(); ++it) {
+		++offsets[it->name + 1];
+	}
+	for (quint32 x = 0; x < nameCount; ++x) {
+		offsets[x + 1] += offsets[x];
+	}
+	std::vector<quint32> owners(m_entries.size());
+	std::vector<quint32> next(offsets.begin(), offsets.end() - 1);
+	for (std::vector<Entry>::const_iterator it = m_entries.begin(); it != m_entries.end(); ++it) {
+		owners[next[it->name]++] = it->owner;
+	}
+	m_ownersByName.clear();
+	m_ownersByNameOffsets.assign(1, 0);
+	for (quint32 x = 0; x < nameCount; ++x) {
+		std::vector<quint32>::iterator first = owners.begin() + offsets[x];
+		std::vector<quint32>::iterator last  = owners.begin() + offsets[x + 1];
+		std::sort(first, last);
+		m_ownersByName.insert(m_ownersByName.end(), first, std::unique(first, last));
+		m_ownersByNameOffsets.push_back(m_ownersByName.size());
+	}
+
+	m_nameTrigrams.clear();
+	if (searchable) {
+		for (quint32 x = 0; x < nameCount; ++x) {
+			m_nameTrigrams.add(x, m_names.constData() + m_nameOffsets[x], m_nameOffsets[x + 1] - m_nameOffsets[x]);
+		}
+		m_nameTrigrams.finish();
+	}
+}
+
+FileOwnershipIndex::TOwners FileOwnershipIndex::findOwners(const QString& path) const
+{
+	TOwners result;
+	QByteArray relative = path.toUtf8();
+	while (relative.startsWith('/')) relative.remove(0, 1);
+	if (relative.isEmpty())
+		return result;
+
+	find(relative, result);
+	// "-Qo /usr/bin" reports the owners of the directory
+	if (result.empty() && relative.endsWith('/') == false)
+		find(relative + '/', result);
+	return result;
+}
+
+FileOwnershipIndex::TOwners FileOwnershipIndex::findOwnersByName(const QString& name) const
+{
+	std::vector<quint32> owners;
+	const QByteArray key = name.toUtf8();
+	QHash<QByteArray, quint32>::const_iterator it = m_nameIds.find(key);
+	if (it != m_nameIds.end())
+		appendOwnersOfName(*it, owners);
+	// directories are stored with their trailing slash
+	it = m_nameIds.find(key + '/');
+	if (it != m_nameIds.end())
+		appendOwnersOfName(*it, owners);
+	return toOwners(owners);
+}
+
+FileOwnershipIndex::TOwners FileOwnershipIndex::findOwnersByNameContaining(const QString& text) const
+{
+	const QByteArray pattern = text.toUtf8();
+	TrigramIndex::TIdList candidates;
+	if (m_nameTrigrams.countPostings() == 0 ||
+	    m_nameTrigrams.findCandidates(pattern.constData(), pattern.size(), candidates) == false)
+		return findOwnersByName(text);
+
+	// verify the candidates, trigrams may occur in another order
+	std::vector<quint32> owners;
+	for (TrigramIndex::TIdList::const_iterator it = candidates.begin(); it != candidates.end(); ++it) {
+		if (TrigramIndex::containsFolded(m_names.constData() + m_nameOffsets[*it],
+		                                 m_nameOffsets[*it + 1] - m_nameOffsets[*it],
+		                                 pattern.constData(), pattern.size()))
+			appendOwnersOfName(*it, owners);
+	}
+	return toOwners(owners);
+}
+
+void FileOwnershipIndex::find(const QByteArray& path, TOwners& result) const
+{
+	const int dirLength = directoryLength(path.constData(), path.size());
+	QHash<QByteArray, quint32>::const_iterator directory = m_directories.find(path.left(dirLength));
+	QHash<QByteArray, quint32>::const_iterator name = m_nameIds.find(path.mid(dirLength));
+	if (directory == m_directories.end() || name == m_nameIds.end())
+		return;
+
+	Entry first;
+	first.directory = *directory;
+	first.name      = *name;
+	first.owner     = 0;
+	for (std::vector<Entry>::const_iterator it = std::lower_bound(m_entries.begin(), m_entries.end(), first);
+	     it != m_entries.end() && it->directory == first.directory && it->name == first.name; ++it) {
+		result.push_back(&m_owners[it->owner]);
+	}
+}
+
+void FileOwnershipIndex::appendOwnersOfName(const quint32 name, std::vector<quint32>& owners) const
+{
+	owners.insert(owners.end(), m_ownersByName.begin() + m_ownersByNameOffsets[name],
+	              m_ownersByName.begin() + m_ownersByNameOffsets[name + 1]);
+}
+
+/**
+ * @brief distinct owners in order of their ids
+ */
+FileOwnershipIndex::TOwners FileOwnershipIndex::toOwners(std::vector<quint32>& owners) const
+{
+	std::sort(owners.begin(), owners.end());
+	owners.erase(std::unique(owners.begin(), owners.end()), owners.end());
+
+	TOwners result;
+	result.reserve(owners.size());
+	for (std::vector<quint32>::const_iterator it = owners.begin(); it != owners.end(); ++it) {
+		result.push_back(&m_owners[*it]);
+	}
+	return result;
+}
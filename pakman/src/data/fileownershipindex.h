@@ -0,0 +1,119 @@
+/*
+* This file is part of pakman, an open-source GUI for pacman.
+* Copyright (C) 2014 Thomas Binkau
+*
+* This program is free software; you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation; either version 2 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+*
+*/
+
+#ifndef FILEOWNERSHIPINDEX_H
+#define FILEOWNERSHIPINDEX_H
+
+#include <vector>
+#include <QByteArray>
+#include <QHash>
+#include <QString>
+#include <QStringList>
+
+#include "src/data/trigramindex.h"
+
+
+/**
+ * @brief Owners of all files of a set of packages, same answers as "-Qo" (local) or "-F" (sync .files)
+ *
+ * Directories and base names are interned (every package installs into usr/, usr/bin/, ...), a file
+ * is stored as (directory id, name id, owner) and the table is sorted by these ids, so a lookup is
+ * two hash lookups plus a binary search. Optionally the base names get a TrigramIndex for substring
+ * searches. The index is immutable after finish() and may be shared.
+ */
+class FileOwnershipIndex
+{
+public:
+	struct Owner {
+		QString repository; // empty for installed packages
+		QString name;
+		QString version;
+	};
+	typedef std::vector<const Owner*> TOwners;
+
+public:
+	FileOwnershipIndex();
+
+	/**
+	 * @return owner id for addPath
+	 */
+	quint32 addPackage(const QString& repository, const QString& name, const QString& version);
+	/**
+	 * @brief adds a path as stored in the files list: relative to / and directories with a trailing slash
+	 */
+	void addPath(const quint32 owner, const char* path, const int length);
+	/**
+	 * @brief sorts the table, must be called once after all paths have been added
+	 * @param searchable (builds the trigram index needed by findOwnersByNameContaining)
+	 */
+	void finish(const bool searchable);
+
+	/**
+	 * @brief all packages owning %path (absolute, a directory may be given without trailing slash)
+	 */
+	TOwners findOwners(const QString& path) const;
+	/**
+	 * @brief all packages owning a file called %name in any directory
+	 */
+	TOwners findOwnersByName(const QString& name) const;
+	/**
+	 * @brief all packages owning a file whose name contains %text (ASCII case insensitive)
+	 *
+	 * requires finish(true) and at least 3 characters, falls back to findOwnersByName otherwise
+	 */
+	TOwners findOwnersByNameContaining(const QString& text) const;
+
+	inline quint32 countPackages() const {
+		return m_owners.size();
+	}
+	inline quint32 countPaths() const {
+		return m_entries.size();
+	}
+
+private:
+	struct Entry {
+		quint32 directory;
+		quint32 name;
+		quint32 owner;
+
+		inline bool operator<(const Entry& other) const {
+			if (directory != other.directory) return directory < other.directory;
+			if (name != other.name) return name < other.name;
+			return owner < other.owner;
+		}
+	};
+
+	void find(const QByteArray& path, TOwners& result) const;
+	void appendOwnersOfName(const quint32 name, std::vector<quint32>& owners) const;
+	TOwners toOwners(std::vector<quint32>& owners) const;
+
+private:
+	std::vector<Owner>          m_owners;
+	QHash<QByteArray, quint32>  m_directories;  // with trailing slash ("usr/bin/") -> directory id
+	QHash<QByteArray, quint32>  m_nameIds;      // base name -> name id
+	QByteArray                  m_names;        // all base names (utf8)
+	std::vector<quint32>        m_nameOffsets;  // number of names + 1 entries
+	std::vector<Entry>          m_entries;      // sorted after finish
+	std::vector<quint32>        m_ownersByName; // distinct owners of each name (sorted)
+	std::vector<quint32>        m_ownersByNameOffsets;
+	TrigramIndex                m_nameTrigrams; // by name id, only if searchable
+};
+
+#endif // FILEOWNERSHIPINDEX_H
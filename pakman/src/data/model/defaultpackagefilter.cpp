@@ -20,92 +20,263 @@
 
 #include "defaultpackagefilter.h"
 
+#include <utility>
+
 #include "packagemodel.h"
+#include "src/data/fileownershipindex.h"
+#include "src/data/trigramindex.h"
 
 
 DefaultPackageFilter::DefaultPackageFilter()
-	: m_filterExplicitlyInstalled(true), m_filterImplicitlyInstalled(true),
-    m_filterRequired(true), m_filterNotRequired(true), m_filterPackagesNotInThisGroup(),
-	  m_filterColumn(-1), m_filterRegExp("", Qt::CaseInsensitive, QRegExp::RegExp)
+	: m_hiddenFacets(0), m_filterGroupMatch(eMatchAnyGroup),
+	  m_filterColumn(-1), m_visibleRepositories(~quint64(0)), m_visibleRepositoriesGeneration(0),
+	  m_matcher(SearchMatcher::compile(QString())),
+	  m_searchRestricted(false), m_searchPackagesValid(false), m_searchPackagesColumn(-1),
+	  m_searchPackagesGeneration(0),
+	  m_changedSinceEvaluation(true), m_evaluatedColumn(-1), m_evaluatedMatcher(m_matcher)
 {
-	m_filterPackageStatus.fill(true);
 }
 
-const PackageRepository::TListOfPackages& DefaultPackageFilter::getBasePackageList(const PackageRepository& repo)
+const PackageRepository::TListOfIds& DefaultPackageFilter::getBasePackageList(const PackageRepository& repo)
 {
-	return repo.getPackageList(m_filterPackagesNotInThisGroup);
+	// repository ids change with every reset of the store
+	if (m_visibleRepositoriesGeneration != repo.getStore().getGeneration())
+		compileRepositoryFilter(repo.getStore());
+	updateSearchPackages(repo);
+
+	// no need to combine anything for a single group
+	if (m_filterExcludedGroups.isEmpty()) {
+		if (m_filterGroups.isEmpty())
+			return repo.getStore().getIds();
+		const PackageRepository::Group*const group = m_filterGroups.size() == 1 ? repo.findGroup(m_filterGroups.first())
+		                                                                        : nullptr;
+		if (group != nullptr)
+			return group->getPackageList();
+	}
+
+	PackageBitset packages(repo.getStore().size());
+	packages.fill(m_filterGroups.isEmpty() || m_filterGroupMatch == eMatchAllGroups);
+	foreach (const QString& name, m_filterGroups) {
+		const PackageRepository::Group*const group = repo.findGroup(name);
+		if (m_filterGroupMatch == eMatchAnyGroup) {
+			if (group != nullptr) packages |= group->getMembers();
+		}
+		else {
+			if (group != nullptr) packages &= group->getMembers();
+			else packages.fill(false);
+		}
+	}
+	foreach (const QString& name, m_filterExcludedGroups) {
+		const PackageRepository::Group*const group = repo.findGroup(name);
+		if (group != nullptr) packages.subtract(group->getMembers());
+	}
+	packages.toIds(m_groupPackages);
+	return m_groupPackages;
 }
 
-bool DefaultPackageFilter::mustFilterPackage(const PackageRepository::PackageData& package)
+bool DefaultPackageFilter::mustFilterPackage(const PackageStore& store, const quint32 id)
 {
-	if ((m_filterImplicitlyInstalled == false && package.explicitlyInstalled == false
-	     && package.status != epkg_NON_INSTALLED)
-	    || (m_filterExplicitlyInstalled == false && package.explicitlyInstalled == true))
+	// explicit / implicit, required / not required and status
+	if ((store.facets(id) & m_hiddenFacets) != 0)
 		return true;
 
-	if ((m_filterRequired == false && package.required == true && package.status != epkg_NON_INSTALLED)
-	    || (m_filterNotRequired == false && package.required == false))
+	if (mustFilterPackageByRepo(store, id))
 		return true;
 
-	if (m_filterPackageStatus[package.status] == false)
+	if (m_searchRestricted && m_searchPackages.test(id) == false)
 		return true;
 
-	if (m_filterRegExp.isEmpty() == false) {
+	if (m_matcher->getKind() != SearchMatcher::eMatchAll) {
 		switch (m_filterColumn) {
 		case PackageModel::ctn_PACKAGE_NAME_COLUMN:
-			if (m_filterRegExp.indexIn(package.name) == -1)
+			if (m_matcher->matches(store.nameData(id), store.nameLength(id)) == false)
 				return true;
 			break;
 		case PackageModel::ctn_PACKAGE_DESCRIPTION_FILTER_NO_COLUMN:
-			if (m_filterRegExp.indexIn(package.description) == -1)
+			if (m_matcher->matches(store.package(id)->description) == false)
 				return true;
 			break;
+		case PackageModel::ctn_PACKAGE_FILE_FILTER_NO_COLUMN:
+			break; // see m_searchPackages
 		default:
 			assert(false);
 			break;
 		}
 	}
-	return mustFilterPackageByRepo(package);
+	return false;
+}
+
+bool DefaultPackageFilter::isRefinement() const
+{
+	if (m_changedSinceEvaluation || m_filterColumn != m_evaluatedColumn)
+		return false;
+	if (m_matcher->getText() == m_evaluatedMatcher->getText())
+		return true;
+
+	// exact base names are no substrings
+	return (m_filterColumn == PackageModel::ctn_PACKAGE_NAME_COLUMN ||
+	        m_filterColumn == PackageModel::ctn_PACKAGE_DESCRIPTION_FILTER_NO_COLUMN) &&
+	       m_matcher->isRefinementOf(*m_evaluatedMatcher);
+}
+
+void DefaultPackageFilter::evaluated()
+{
+	m_changedSinceEvaluation = false;
+	m_evaluatedColumn        = m_filterColumn;
+	m_evaluatedMatcher       = m_matcher;
+}
+
+std::unique_ptr<IPackageFilter> DefaultPackageFilter::clone() const
+{
+	return std::unique_ptr<IPackageFilter>(new DefaultPackageFilter(*this));
 }
 
 void DefaultPackageFilter::applyFilter(const bool explicitsVisible, const bool implicitsVisible,
                                        const bool requiredVisible, const bool notRequiredVisible,
                                        const TStatusFilter& filter)
 {
-	m_filterExplicitlyInstalled = explicitsVisible;
-	m_filterImplicitlyInstalled = implicitsVisible;
-	m_filterRequired = requiredVisible;
-	m_filterNotRequired = notRequiredVisible;
-	m_filterPackageStatus = filter;
+	m_hiddenFacets = (explicitsVisible ? 0 : PackageStore::eFacetExplicit) |
+	                 (implicitsVisible ? 0 : PackageStore::eFacetImplicitInstalled) |
+	                 (requiredVisible ? 0 : PackageStore::eFacetRequiredInstalled) |
+	                 (notRequiredVisible ? 0 : PackageStore::eFacetNotRequired);
+	for (std::size_t status = 0; status < filter.size(); ++status) {
+		if (filter[status] == false) m_hiddenFacets |= PackageStore::statusFacet(static_cast<PackageStatus>(status));
+	}
+	m_changedSinceEvaluation = true;
 }
 
-bool DefaultPackageFilter::applyFilter(QSet<QString>&& filter)
+bool DefaultPackageFilter::applyFilter(QSet<QString>&& filter, const PackageStore& store)
 {
-	if (filter == m_filterRepo) return false;
+	if (filter == m_filterRepo && m_visibleRepositoriesGeneration == store.getGeneration()) return false;
 
 	m_filterRepo = std::move(filter);
+	compileRepositoryFilter(store);
+	m_changedSinceEvaluation = true;
 	return true;
 }
 
-void DefaultPackageFilter::applyGroupFilter(const QString& group)
+void DefaultPackageFilter::applyGroupFilter(const QStringList& groups, const EGroupMatch match,
+                                            const QStringList& excludedGroups)
 {
-	m_filterPackagesNotInThisGroup = group;
+	m_filterGroups         = groups;
+	m_filterGroupMatch     = match;
+	m_filterExcludedGroups = excludedGroups;
+	m_changedSinceEvaluation = true;
 }
 
 void DefaultPackageFilter::applySearchFilter(const int filterColumn)
 {
-	applySearchFilter(filterColumn, m_filterRegExp.pattern());
+	m_filterColumn = filterColumn;
 }
 
-void DefaultPackageFilter::applySearchFilter(const QString& filterExp)
+void DefaultPackageFilter::applySearchFilter(const QString& text, const std::shared_ptr<const FileOwnershipIndex>& fileIndex)
 {
-	applySearchFilter(m_filterColumn, filterExp);
+	assert(text.isNull() == false);
+	if (text == m_matcher->getText() && fileIndex == m_fileIndex)
+		return;
+
+	// another index may know other owners of the same file
+	if (fileIndex != m_fileIndex) m_changedSinceEvaluation = true;
+	m_matcher             = SearchMatcher::compile(text);
+	m_filterText          = text.trimmed();
+	m_fileIndex           = fileIndex;
+	m_searchPackagesValid = false;
 }
 
-void DefaultPackageFilter::applySearchFilter(const int filterColumn, const QString& filterExp)
+/**
+ * @brief translates the repository names to the repository mask of %store
+ *
+ * the mask is not exact for more than ctn_MAX_MASKED_REPOSITORIES repositories, every repository id is
+ * looked up then
+ */
+void DefaultPackageFilter::compileRepositoryFilter(const PackageStore& store)
 {
-	assert(filterExp.isNull() == false);
-//  std::cout << "apply new column filter " << filterColumn << ", " << filterExp.toStdString() << std::endl;
-	m_filterColumn = filterColumn;
-	m_filterRegExp.setPattern(filterExp);
+	m_visibleRepositoryIds.clear();
+	if (m_filterRepo.isEmpty()) {
+		m_visibleRepositories = ~quint64(0);
+	}
+	else if (store.getRepositories().size() <= PackageStore::ctn_MAX_MASKED_REPOSITORIES) {
+		m_visibleRepositories = store.repositoryMask(m_filterRepo);
+	}
+	else {
+		m_visibleRepositories = 0;
+		m_visibleRepositoryIds.resize(store.getRepositories().size(), false);
+		foreach (const QString& repository, m_filterRepo) {
+			const int repositoryId = store.findRepositoryId(repository);
+			if (repositoryId != -1) m_visibleRepositoryIds[repositoryId] = true;
+		}
+	}
+	m_visibleRepositoriesGeneration = store.getGeneration();
+}
+
+/**
+ * @brief looks up the candidates of the search in the indices of %repo (only if something changed)
+ */
+void DefaultPackageFilter::updateSearchPackages(const PackageRepository& repo)
+{
+	const PackageStore& store = repo.getStore();
+	if (m_searchPackagesValid && m_searchPackagesColumn == m_filterColumn &&
+	    m_searchPackagesGeneration == store.getGeneration())
+		return;
+
+	m_searchPackagesValid      = true;
+	m_searchPackagesColumn     = m_filterColumn;
+	m_searchPackagesGeneration = store.getGeneration();
+	m_searchRestricted         = false;
+	m_searchPackages           = PackageBitset();
+	if (m_filterText.isEmpty())
+		return;
+
+	switch (m_filterColumn) {
+	case PackageModel::ctn_PACKAGE_DESCRIPTION_FILTER_NO_COLUMN:
+		updateDescriptionCandidates(repo.getDescriptionIndex(), store.size());
+		break;
+	case PackageModel::ctn_PACKAGE_FILE_FILTER_NO_COLUMN:
+		updateFileOwners(store);
+		break;
+	default:
+		break;
+	}
+}
+
+/**
+ * @brief packages containing all trigrams of all required literals, the matcher verifies them
+ */
+void DefaultPackageFilter::updateDescriptionCandidates(const TrigramIndex& index, const quint32 packageCount)
+{
+	TrigramIndex::TIdList candidates;
+	foreach (const QString& literal, m_matcher->getRequiredLiterals()) {
+		const QByteArray text = literal.toLower().toUtf8();
+		if (index.findCandidates(text.constData(), text.size(), candidates) == false)
+			continue; // too short
+		PackageBitset found(packageCount, candidates);
+		if (m_searchRestricted) m_searchPackages &= found;
+		else m_searchPackages = std::move(found);
+		m_searchRestricted = true;
+	}
+}
+
+/**
+ * @brief translates the owners of the searched files to the ids of %store
+ */
+void DefaultPackageFilter::updateFileOwners(const PackageStore& store)
+{
+	// without an index no package matches
+	m_searchRestricted = true;
+	m_searchPackages   = PackageBitset(store.size());
+	if (m_fileIndex == nullptr)
+		return;
+
+	const FileOwnershipIndex::TOwners owners = m_filterText.contains('/')
+	                                           ? m_fileIndex->findOwners(m_filterText)
+	                                           : m_fileIndex->findOwnersByNameContaining(m_filterText);
+	for (FileOwnershipIndex::TOwners::const_iterator it = owners.begin(); it != owners.end(); ++it) {
+		const int repositoryId = store.findRepositoryId((*it)->repository);
+		if (repositoryId == -1)
+			continue;
+		const PackageNameIndex::TIdRange ids = store.findByName((*it)->name);
+		for (quint32 id = ids.first; id < ids.second; ++id) {
+			if (store.repositoryId(id) == repositoryId) m_searchPackages.set(id);
+		}
+	}
 }
@@ -21,46 +21,94 @@
 #ifndef DEFAULTPACKAGEFILTER_H
 #define DEFAULTPACKAGEFILTER_H
 
+#include <memory>
+#include <vector>
 #include "src/data/model/packagefilter.h"
+#include "src/data/searchmatcher.h"
+
+class FileOwnershipIndex;
+class TrigramIndex;
 
 
 class DefaultPackageFilter : public IPackageFilter {
 public:
 	typedef std::array<bool, PackageStatus::epkg_FOREIGN_OUTDATED+1> TStatusFilter;
 
+	enum EGroupMatch {
+		eMatchAnyGroup, // union of the selected groups
+		eMatchAllGroups // intersection of the selected groups
+	};
+
 public:
 	DefaultPackageFilter();
 
 	// this function should be as fast as possible
-	virtual const PackageRepository::TListOfPackages& getBasePackageList(const PackageRepository& repo) override;
-	// this function will be called for each item in the base package list
-	virtual bool mustFilterPackage(const PackageRepository::PackageData& package) override;
+	virtual const PackageRepository::TListOfIds& getBasePackageList(const PackageRepository& repo) override;
+	// this function will be called for each item in the base package list (concurrently, read only)
+	virtual bool mustFilterPackage(const PackageStore& store, const quint32 id) override;
+	// only a narrower literal or prefix search (in the same column) is detected as refinement
+	virtual bool isRefinement() const override;
+	virtual void evaluated() override;
+	virtual std::unique_ptr<IPackageFilter> clone() const override;
 
 	/// do not call any of the methods in this block unsynchronized
 	void applyFilter(const bool explicitsVisible, const bool implicitsVisible,
 	                 const bool requiredVisible, const bool notRequiredVisible, const TStatusFilter& filter);
-	bool applyFilter(QSet<QString>&& filter);
-	void applyGroupFilter(const QString& group); // NULL String == no filter
+	/**
+	 * @brief restricts to the packages of the repositories in %filter (empty == all repositories)
+	 * @param store (the filter is compiled for, other stores are compiled by getBasePackageList)
+	 * @return false if nothing changed
+	 */
+	bool applyFilter(QSet<QString>&& filter, const PackageStore& store);
+	/**
+	 * @brief restricts to packages of %groups (empty == all packages) without the packages of %excludedGroups
+	 */
+	void applyGroupFilter(const QStringList& groups, const EGroupMatch match, const QStringList& excludedGroups);
 	void applySearchFilter(const int filterColumn);
-	void applySearchFilter(const QString& filterExp);
-	void applySearchFilter(const int filterColumn, const QString& filterExp);
+	/**
+	 * @brief search text as entered (see SearchMatcher), candidates are looked up in the indices first
+	 * @param fileIndex (files of the sync packages, nullptr while not available: no package will match)
+	 *
+	 * for ctn_PACKAGE_FILE_FILTER_NO_COLUMN a path (containing '/') must match exactly, otherwise %text is part
+	 * of a file name
+	 */
+	void applySearchFilter(const QString& text, const std::shared_ptr<const FileOwnershipIndex>& fileIndex);
 
 private:
-	inline bool mustFilterPackageByRepo(const PackageRepository::PackageData& package) const {
-		return m_filterRepo.empty() == false && m_filterRepo.contains(package.repository) == false;
+	inline bool mustFilterPackageByRepo(const PackageStore& store, const quint32 id) const {
+		if (m_visibleRepositoryIds.empty())
+			return (m_visibleRepositories & store.repositoryBit(id)) == 0;
+		return m_visibleRepositoryIds[store.repositoryId(id)] == false;
 	}
+	void compileRepositoryFilter(const PackageStore& store);
+	void updateSearchPackages(const PackageRepository& repo);
+	void updateDescriptionCandidates(const TrigramIndex& index, const quint32 packageCount);
+	void updateFileOwners(const PackageStore& store);
 
 private:
-	// Filter attributes, for all bool true = visible
-	bool          m_filterExplicitlyInstalled;
-	bool          m_filterImplicitlyInstalled;
-	bool          m_filterRequired;
-	bool          m_filterNotRequired;
-	TStatusFilter m_filterPackageStatus; // true = visible
-	QString       m_filterPackagesNotInThisGroup;
+	// Filter attributes
+	quint16       m_hiddenFacets;        // PackageStore::EFacets, compiled from the explicit, required and status filters
+	QStringList   m_filterGroups;
+	EGroupMatch   m_filterGroupMatch;
+	QStringList   m_filterExcludedGroups;
 	int           m_filterColumn;
 	QSet<QString> m_filterRepo;          // contained = visible
-	QRegExp       m_filterRegExp;
+	quint64       m_visibleRepositories; // m_filterRepo as repository mask of the store of m_visibleRepositoriesGeneration
+	std::vector<bool> m_visibleRepositoryIds; // by repository id, used instead of the mask for too many repositories
+	quint32       m_visibleRepositoriesGeneration;
+	PackageRepository::TListOfIds m_groupPackages; // result of the group filter (if combined)
+	std::shared_ptr<const SearchMatcher> m_matcher; // never nullptr
+	QString       m_filterText;          // trimmed
+	std::shared_ptr<const FileOwnershipIndex> m_fileIndex;
+	PackageBitset m_searchPackages;      // candidates of the search in the store of m_searchPackagesGeneration
+	bool          m_searchRestricted;    // false: every package is a candidate (m_searchPackages unused)
+	bool          m_searchPackagesValid;
+	int           m_searchPackagesColumn;
+	quint32       m_searchPackagesGeneration;
+	// state of the last evaluation
+	bool          m_changedSinceEvaluation; // anything but the search
+	int           m_evaluatedColumn;
+	std::shared_ptr<const SearchMatcher> m_evaluatedMatcher;
 };
 
 #endif // DEFAULTPACKAGEFILTER_H
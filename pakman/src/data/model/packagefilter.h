@@ -21,19 +21,29 @@
 #ifndef PACKAGEFILTER_H
 #define PACKAGEFILTER_H
 
+#include <memory>
 #include <QRegExp>
 #include "src/data/packagerepository.h"
+#include "src/data/packagestore.h"
 
 
 class IPackageFilter {
 public:
 	virtual ~IPackageFilter() {}
 
-	// this function should be as fast as possible
-	// return value should be provided sorted by name (should already be done by repo)
-	virtual const PackageRepository::TListOfPackages& getBasePackageList(const PackageRepository& repo) = 0;
-	// this function will be called for each item in the base package list
-	virtual bool mustFilterPackage(const PackageRepository::PackageData& package) = 0;
+	// this function should be as fast as possible, it may prepare the filter for repo.getStore()
+	// return value should be provided sorted by name (sorted ids, should already be done by repo)
+	virtual const PackageRepository::TListOfIds& getBasePackageList(const PackageRepository& repo) = 0;
+	// this function will be called for each id in the base package list, concurrently by several threads
+	// (after getBasePackageList): it must not modify the filter
+	virtual bool mustFilterPackage(const PackageStore& store, const quint32 id) = 0;
+	// true if the filter only narrowed since the last evaluation: every package passing it now passed it before
+	// (the base package list is unchanged, only the previous result needs to be filtered again)
+	virtual bool isRefinement() const = 0;
+	// called after each evaluation (of the base package list or the previous result)
+	virtual void evaluated() = 0;
+	// copy to be evaluated exclusively by a worker thread
+	virtual std::unique_ptr<IPackageFilter> clone() const = 0;
 };
 
 #endif // PACKAGEFILTER_H
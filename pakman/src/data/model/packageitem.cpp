@@ -29,16 +29,16 @@
 /*
  * Will create root item and fetch 2 levels to make incremental fetch possible
  */
-PackageItem::PackageItem(PackageItem::TPkgVec& children, EDirection mode)
- : m_parent(*static_cast<PackageItem*>(NULL)),
+PackageItem::PackageItem(const PackageRepository& repo, const TIdRange& children, EDirection mode)
+ : m_repo(repo), m_parent(*static_cast<PackageItem*>(NULL)), m_id(0),
 	 m_package(*static_cast<PackageRepository::PackageData*>(NULL))
 {
 	fetchDepenciesFrom(children);
 	fetchDepencies(mode);
 }
 
-PackageItem::PackageItem(const PackageItem& parent, const PackageRepository::PackageData& package)
- : m_parent(parent), m_package(package)
+PackageItem::PackageItem(const PackageItem& parent, const quint32 id)
+ : m_repo(parent.m_repo), m_parent(parent), m_id(id), m_package(*parent.m_repo.getStore().package(id))
 {
 }
 
@@ -47,12 +47,12 @@ PackageItem::~PackageItem()
 	_deleteChildPackageItems();
 }
 
-bool PackageItem::canFetchChildren(EDirection mode) const
+bool PackageItem::canFetchChildren(EDirection) const
 {
 	if (m_childVec.get() != NULL && m_childVec->empty() == false) {
+		// the dependency graph is always available
 		PackageItem* NEXT = m_childVec->at(0);
-		return (NEXT->m_childVec.get() == NULL
-		        && (mode == DEPENDS_ON ? NEXT->m_package.getDependsOn() : NEXT->m_package.getRequiredBy()) != NULL);
+		return NEXT->m_childVec.get() == NULL;
 	}
 	//  includes (m_childVec.get() == NULL)
 	return false;
@@ -61,12 +61,11 @@ bool PackageItem::canFetchChildren(EDirection mode) const
 void PackageItem::fetchDepencies(EDirection mode)
 {
 	if (m_childVec.get() != NULL) {
+		const DependencyGraph& graph = m_repo.getDependencyGraph();
 		for (std::size_t x = 0; x < m_childVec->size(); ++x) {
-			const PackageRepository::PackageData& childPkg = m_childVec->at(x)->m_package;
-			const TPkgVec* deps2 = (mode == DEPENDS_ON ? childPkg.getDependsOn() : childPkg.getRequiredBy());
-			if (deps2 != NULL) {
-				m_childVec->at(x)->fetchDepenciesFrom(*deps2);
-			}
+			const quint32 childId = m_childVec->at(x)->m_id;
+			m_childVec->at(x)->fetchDepenciesFrom(mode == DEPENDS_ON ? graph.getDependsOn(childId)
+			                                                         : graph.getRequiredBy(childId));
 		}
 	}
 	else std::cerr << strAppName() << " " << strErrorDnfDependencyInfo(m_package.name).toStdString() << std::endl;
@@ -75,7 +74,7 @@ void PackageItem::fetchDepencies(EDirection mode)
 /**
  * @brief Will create child items according to mode and put them in m_childVec
  */
-void PackageItem::fetchDepenciesFrom(PackageItem::TPkgVec& children)
+void PackageItem::fetchDepenciesFrom(const TIdRange& children)
 {
 	if (m_childVec.get() != NULL) {
 		std::cerr << strAppName() << " " << strErrorDependencyInfoAlreadyFetched().toStdString() << std::endl;
@@ -83,10 +82,10 @@ void PackageItem::fetchDepenciesFrom(PackageItem::TPkgVec& children)
 	}
 
 	m_childVec.reset(new std::vector<PackageItem*>());
-	m_childVec->reserve(children.size());
+	m_childVec->reserve(children.second - children.first);
 
-	for (std::size_t x = 0; x < children.size(); ++x) {
-		m_childVec->push_back(new PackageItem(*this, *children[x]));
+	for (const quint32* it = children.first; it != children.second; ++it) {
+		m_childVec->push_back(new PackageItem(*this, *it));
 	}
 }
 
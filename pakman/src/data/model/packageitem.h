@@ -24,6 +24,7 @@
 #include <memory>
 #include <vector>
 
+#include "src/data/dependencygraph.h"
 #include "src/data/packagerepository.h"
 
 /**
@@ -32,7 +33,7 @@
 class PackageItem
 {
 public:
-  typedef const PackageRepository::PackageData::TDependencyVec TPkgVec;
+  typedef DependencyGraph::TIdRange TIdRange;
 
   /**
    * @brief Parent item %EDirection% child items (e.g parent DEPENDS_ON child)
@@ -45,21 +46,20 @@ public:
 public:
   /**
    * @brief Root item constructor
-   * @param children (the package list)
+   * @param repo (dependencies are taken from its DependencyGraph)
+   * @param children (ids of the package list)
    * @param mode (see EDirection)
    *
-   * Make sure dependencies are available already before calling. Will
-   * fetch 2 levels to make incremental fetch from QTreeview possible.
+   * Will fetch 2 levels to make incremental fetch from QTreeview possible.
    */
-  PackageItem(TPkgVec& children, EDirection mode);
+  PackageItem(const PackageRepository& repo, const TIdRange& children, EDirection mode);
 
   /**
    * @brief Child item constructor (will not fetch)
    * @param parent (the parent which requires or depends on this item)
-   * @param package (the package to show in that line)
-   * @param mode (see EDirection)
+   * @param id (of the package to show in that line)
    */
-  PackageItem(const PackageItem& parent, const PackageRepository::PackageData& package);
+  PackageItem(const PackageItem& parent, const quint32 id);
 
   /**
    * @brief will cascade clean up memory acquired. all child items will be invalid
@@ -77,8 +77,7 @@ public:
    * @brief will fetch depencies for children according to mode
    * @param mode (depends or required)
    *
-   * will create PackageItems for children if possible. make sure the dependency
-   * information for all immediate children of this node is available before calling.
+   * will create PackageItems for children if possible.
    * keep in mind that canFetchChildren() will only check the first child.
    */
   void fetchDepencies(EDirection mode);
@@ -106,17 +105,18 @@ public:
 private:
   /**
    * @brief Will create child items according to mode and put them in m_childVec
-   * @param children (in repository format, either dependsOn or requiredBy)
-   * @param mode will only be used to fetch children of the newly created child-items
+   * @param children (ids, either depends on or required by)
    */
-  void fetchDepenciesFrom(TPkgVec& children);
+  void fetchDepenciesFrom(const TIdRange& children);
   /**
    * @brief will cascade clean up memory acquired and set m_childVec to NULL.
    */
   void _deleteChildPackageItems();
 
 private:
+  const PackageRepository&                   m_repo;
   const PackageItem&                         m_parent;   // may still be NULL but only for root items
+  const quint32                              m_id;       // undefined for root items
   const PackageRepository::PackageData&      m_package;  // may still be NULL but only for root items
   std::auto_ptr<std::vector<PackageItem*> >  m_childVec; // all child items of that row according to EDirection setting
 };
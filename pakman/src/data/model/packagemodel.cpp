@@ -20,16 +20,64 @@
 
 #include "packagemodel.h"
 
+#include <algorithm>
 #include <cassert>
+#include <QtConcurrentMap>
+#include <QtConcurrentRun>
+#include "src/data/packagebitset.h"
 #include "src/strconstants.h"
 #include "src/icons.h"
 
 
+namespace {
+
+// number of packages filtered between two checks for a newer request
+const std::size_t ctn_EVALUATION_CANCEL_INTERVAL = 1024;
+// number of packages filtered by one thread at once (the ids and survivors of a chunk fit into the L1 cache)
+const std::size_t ctn_EVALUATION_CHUNK_SIZE = 4096;
+// the view relayouts on every notification, a reset is cheaper for a result differing in more ranges of rows
+const std::size_t ctn_MAX_CHANGED_ROW_RANGES = 128;
+
+/**
+ * @brief a range of the input of a filter run and the ids passing the filter (in order)
+ */
+struct FilterChunk {
+	const quint32*                first;
+	const quint32*                last;
+	PackageRepository::TListOfIds survivors;
+};
+
+/**
+ * @brief filters one chunk, may run concurrently for different chunks
+ */
+struct TFilterChunk {
+	TFilterChunk(const PackageStore& store, IPackageFilter& filter,
+	             const std::atomic<quint32>& generation, const quint32 expectedGeneration)
+		: m_store(store), m_filter(filter), m_generation(generation), m_expectedGeneration(expectedGeneration)
+	{}
+	void operator()(FilterChunk& chunk) const {
+		chunk.survivors.reserve(chunk.last - chunk.first);
+		for (const quint32* it = chunk.first; it != chunk.last; ++it) {
+			if ((it - chunk.first) % ctn_EVALUATION_CANCEL_INTERVAL == 0 && m_generation != m_expectedGeneration)
+				return;
+			if (m_filter.mustFilterPackage(m_store, *it)) continue;
+			chunk.survivors.push_back(*it);
+		}
+	}
+	const PackageStore&         m_store;
+	IPackageFilter&             m_filter;
+	const std::atomic<quint32>& m_generation;
+	const quint32               m_expectedGeneration;
+};
+
+}
+
+
 PackageModel::PackageModel(const PackageRepository& repo, QObject *parent)
 : QAbstractItemModel(parent), m_packageRepo(repo), m_displayMode(FLAT),
   m_rootItem(createDummyRoot()),
-  m_sortOrder(Qt::AscendingOrder), m_sortColumn(1),
-  m_filter(new DefaultPackageFilter()),
+  m_sortOrder(Qt::AscendingOrder), m_sortColumn(1), m_rowsSortColumn(1),
+  m_filter(new DefaultPackageFilter()), m_rowsState(eRowsValid), m_generation(0),
   m_iconNotInstalled(iconPkgNotInstalled()), m_iconInstalled(iconPkgInstalled()),
   m_iconInstalledUnrequired(iconPkgInstalledUnrequired()),
   m_iconNewer(iconPkgInstalledNewer()), m_iconOutdated(iconPkgInstalledOutdated()),
@@ -38,7 +86,14 @@ PackageModel::PackageModel(const PackageRepository& repo, QObject *parent)
   m_iconNewerByUser(iconPkgExplicitlyInstalledNewer()),
   m_iconOutdatedByUser(iconPkgExplicitlyInstalledOutdated()),
   m_iconForeign(iconPkgInstalledAUR()), m_iconForeignOutdated(iconPkgInstalledOutdatedAUR())
-{}
+{
+	connect(&m_evaluationWatch, SIGNAL(finished()), this, SLOT(evaluationFinished()));
+}
+
+PackageModel::~PackageModel()
+{
+	cancelEvaluation();
+}
 
 QModelIndex PackageModel::index(int row, int column, const QModelIndex &parent) const
 {
@@ -50,7 +105,8 @@ QModelIndex PackageModel::index(int row, int column, const QModelIndex &parent)
 		if (!parent.isValid()) {
 			const int adaptedRow = transformRowIndex(row, m_columnSortedlistOfPackages.size());
 			if (adaptedRow >= 0 && static_cast<size_t>(adaptedRow) < m_columnSortedlistOfPackages.size()) {
-				return createIndex(row, column, (void*)m_columnSortedlistOfPackages.at(adaptedRow));
+				const quint32 id = m_columnSortedlistOfPackages.at(adaptedRow);
+				return createIndex(row, column, (void*)m_packageRepo.getStore().package(id));
 			}
 		}
 		return QModelIndex();
@@ -190,19 +246,24 @@ void PackageModel::sort(int column, Qt::SortOrder order)
 {
 //  std::cout << "sort column " << column << " in order " << order << std::endl;
 
-	if (column != m_sortColumn || order != m_sortOrder) {
+	// the order is applied by transformRowIndex, a new column is sorted in the background
+	if (order != m_sortOrder) {
 		if (m_displayMode == FLAT)
 			emit layoutAboutToBeChanged();
-		m_sortColumn = column;
-		m_sortOrder  = order;
-		sort();
+		m_sortOrder = order;
 		if (m_displayMode == FLAT)
 			emit layoutChanged();
 	}
+	if (column != m_sortColumn) {
+		m_sortColumn = column;
+		requestEvaluation(eRowsUnsorted);
+	}
 }
 
 void PackageModel::beginResetRepository(PackageRepository::EResetType)
 {
+	// the worker reads the repository, it must not change while an evaluation runs
+	cancelEvaluation();
 	beginResetModel();
 	m_listOfPackages.clear();
 	m_columnSortedlistOfPackages.clear();
@@ -210,18 +271,10 @@ void PackageModel::beginResetRepository(PackageRepository::EResetType)
 
 void PackageModel::endResetRepository(PackageRepository::EResetType)
 {
-	const PackageRepository::TListOfPackages& data = m_filter->getBasePackageList(m_packageRepo);
-	m_listOfPackages.reserve(data.size());
-	for (PackageRepository::TListOfPackages::const_iterator it = data.begin(); it != data.end(); ++it) {
-		if (m_filter->mustFilterPackage(**it)) continue;
-		m_listOfPackages.push_back(*it);
-	}
-	m_columnSortedlistOfPackages.reserve(data.size());
-	m_columnSortedlistOfPackages = m_listOfPackages;
-	sort();
 	if (m_displayMode == FLAT)
 		m_rootItem.reset(createDummyRoot());
 	endResetModel();
+	requestEvaluation(eRowsInvalid);
 }
 
 int PackageModel::getPackageCount() const
@@ -253,9 +306,196 @@ void PackageModel::switchDisplayMode(PackageModel::EDisplayMode newMode)
 
 void PackageModel::setNewFilter(std::unique_ptr<IPackageFilter>&& filter)
 {
-	beginResetRepository(PackageRepository::eResetRepository);
 	m_filter = std::move(filter);
-	endResetRepository(PackageRepository::eResetRepository);
+	requestEvaluation(eRowsInvalid);
+}
+
+/**
+ * @brief schedules the evaluation of the rows, replaces a pending request and cancels a running one
+ */
+void PackageModel::requestEvaluation(const ERowsState state)
+{
+	m_rowsState = std::max(m_rowsState, state);
+
+	std::unique_ptr<Evaluation> evaluation(new Evaluation());
+	evaluation->generation = ++m_generation;
+	evaluation->refine     = m_rowsState == eRowsUnfiltered && m_filter->isRefinement();
+	evaluation->sortColumn = m_sortColumn;
+	evaluation->completed  = false;
+	if (m_rowsState >= eRowsUnfiltered)
+		evaluation->filter = m_filter->clone();
+	if (m_rowsState != eRowsInvalid)
+		evaluation->rows = m_listOfPackages;
+	m_pendingEvaluation = std::move(evaluation);
+
+	if (m_evaluationWatch.isRunning() == false)
+		startPendingEvaluation();
+}
+
+void PackageModel::startPendingEvaluation()
+{
+	m_runningEvaluation = std::move(m_pendingEvaluation);
+	QFuture<void> future = QtConcurrent::run(this, &PackageModel::evaluate, m_runningEvaluation.get());
+	m_evaluationWatch.setFuture(future);
+}
+
+/**
+ * @brief drops the pending request and waits for the running evaluation to give up
+ */
+void PackageModel::cancelEvaluation()
+{
+	++m_generation;
+	m_pendingEvaluation.reset();
+	m_evaluationWatch.waitForFinished();
+	m_runningEvaluation.reset();
+}
+
+/**
+ * @brief runs in a worker thread, the repository does not change meanwhile (see beginResetRepository)
+ *
+ * gives up as soon as a newer evaluation has been requested
+ */
+void PackageModel::evaluate(Evaluation*const evaluation) const
+{
+	const PackageStore& store = m_packageRepo.getStore();
+	if (evaluation->filter != nullptr) {
+		IPackageFilter& filter = *evaluation->filter;
+		// prepares the filter for the current store in any case
+		const PackageRepository::TListOfIds& data = filter.getBasePackageList(m_packageRepo);
+		const PackageRepository::TListOfIds& input = evaluation->refine ? evaluation->rows : data;
+
+		// the chunks are filtered by the global thread pool (this thread included), the survivors are
+		// concatenated in the order of the chunks to keep the order by name
+		std::vector<FilterChunk> chunks((input.size() + ctn_EVALUATION_CHUNK_SIZE - 1) / ctn_EVALUATION_CHUNK_SIZE);
+		for (std::size_t x = 0; x < chunks.size(); ++x) {
+			chunks[x].first = input.data() + x * ctn_EVALUATION_CHUNK_SIZE;
+			chunks[x].last  = input.data() + std::min(input.size(), (x + 1) * ctn_EVALUATION_CHUNK_SIZE);
+		}
+		QtConcurrent::blockingMap(chunks, TFilterChunk(store, filter, m_generation, evaluation->generation));
+		if (evaluation->generation != m_generation)
+			return;
+
+		std::size_t count = 0;
+		for (std::vector<FilterChunk>::const_iterator it = chunks.begin(); it != chunks.end(); ++it) {
+			count += it->survivors.size();
+		}
+		PackageRepository::TListOfIds rows;
+		rows.reserve(count);
+		for (std::vector<FilterChunk>::const_iterator it = chunks.begin(); it != chunks.end(); ++it) {
+			rows.insert(rows.end(), it->survivors.begin(), it->survivors.end());
+		}
+		filter.evaluated();
+		evaluation->rows.swap(rows);
+	}
+	if (evaluation->generation != m_generation)
+		return;
+
+	evaluation->sortedRows = evaluation->rows;
+	sortRows(store, evaluation->sortColumn, evaluation->sortedRows);
+	evaluation->completed = true;
+}
+
+/**
+ * @brief applies the rows of the finished evaluation unless it has been superseded
+ */
+void PackageModel::evaluationFinished()
+{
+	// a late signal of a finished future, the running evaluation has been started afterwards
+	if (m_evaluationWatch.isRunning())
+		return;
+
+	std::unique_ptr<Evaluation> evaluation = std::move(m_runningEvaluation);
+	if (m_pendingEvaluation != nullptr)
+		startPendingEvaluation();
+	if (evaluation == nullptr || evaluation->completed == false || evaluation->generation != m_generation)
+		return;
+
+	if (evaluation->filter == nullptr) {
+		if (m_displayMode == FLAT)
+			emit layoutAboutToBeChanged();
+		m_columnSortedlistOfPackages.swap(evaluation->sortedRows);
+		if (m_displayMode == FLAT)
+			emit layoutChanged();
+	}
+	else if (evaluation->sortColumn != m_rowsSortColumn || changeRows(evaluation->sortedRows) == false) {
+		// another order or too many changes, the view loses its scroll position and selection
+		beginResetModel();
+		m_columnSortedlistOfPackages.swap(evaluation->sortedRows);
+		if (m_displayMode == FLAT)
+			m_rootItem.reset(createDummyRoot());
+		endResetModel();
+	}
+	m_listOfPackages.swap(evaluation->rows);
+	m_rowsSortColumn = evaluation->sortColumn;
+	// the copy has the same settings and knows the evaluated state
+	if (evaluation->filter != nullptr) m_filter = std::move(evaluation->filter);
+	m_rowsState = eRowsValid;
+	emit rowsEvaluated();
+}
+
+/**
+ * @brief changes the current rows into %rows (sorted the same way) by removing and inserting ranges of rows
+ * @return false if nothing has been changed because a reset of the model is cheaper
+ *
+ * a row is kept if it is part of both, both are in the same order: the rows not in %rows are removed (from the
+ * back, the positions in front stay valid), then the rows missing from %rows are inserted (from the front, the
+ * rows in front already match %rows)
+ */
+bool PackageModel::changeRows(const PackageRepository::TListOfIds& rows)
+{
+	if (m_displayMode != FLAT)
+		return false;
+
+	PackageRepository::TListOfIds& current = m_columnSortedlistOfPackages;
+	const quint32 packageCount = m_packageRepo.getStore().size();
+	const PackageBitset inCurrent(packageCount, current);
+	const PackageBitset inRows(packageCount, rows);
+
+	std::size_t ranges = 0;
+	for (std::size_t x = 0; x < current.size(); ++x) {
+		if (inRows.test(current[x]) == false && (x == 0 || inRows.test(current[x - 1]))) ++ranges;
+	}
+	for (std::size_t x = 0; x < rows.size(); ++x) {
+		if (inCurrent.test(rows[x]) == false && (x == 0 || inCurrent.test(rows[x - 1]))) ++ranges;
+	}
+	if (ranges > ctn_MAX_CHANGED_ROW_RANGES)
+		return false;
+
+	for (std::size_t end = current.size(); end > 0;) {
+		if (inRows.test(current[end - 1])) {
+			--end;
+			continue;
+		}
+		std::size_t begin = end - 1;
+		while (begin > 0 && inRows.test(current[begin - 1]) == false) --begin;
+
+		const int first = transformRowIndex(begin, current.size());
+		const int last  = transformRowIndex(end - 1, current.size());
+		beginRemoveRows(QModelIndex(), std::min(first, last), std::max(first, last));
+		current.erase(current.begin() + begin, current.begin() + end);
+		endRemoveRows();
+		end = begin;
+	}
+
+	for (std::size_t begin = 0; begin < rows.size();) {
+		if (inCurrent.test(rows[begin])) {
+			++begin;
+			continue;
+		}
+		std::size_t end = begin + 1;
+		while (end < rows.size() && inCurrent.test(rows[end]) == false) ++end;
+
+		// rows of the view after the insertion
+		const int size  = current.size() + (end - begin);
+		const int first = transformRowIndex(begin, size);
+		const int last  = transformRowIndex(end - 1, size);
+		beginInsertRows(QModelIndex(), std::min(first, last), std::max(first, last));
+		current.insert(current.begin() + begin, rows.begin() + begin, rows.begin() + end);
+		endInsertRows();
+		begin = end;
+	}
+	assert(current == rows);
+	return true;
 }
 
 PackageItem& PackageModel::getPackageItem(const QModelIndex& index) const
@@ -303,65 +543,74 @@ const QIcon& PackageModel::getIconFor(const PackageRepository::PackageData& pack
 }
 
 
+/*
+ * All comparators work on the columns of the PackageStore, ids are ordered by name
+ */
 struct TSort0 {
-	bool operator()(const PackageRepository::PackageData* a, const PackageRepository::PackageData* b) const {
-		if (a->status < b->status) return true;
-		if (a->status == b->status) {
-			return a->name < b->name;
+	TSort0(const PackageStore& store) : m_store(store) {}
+	bool operator()(const quint32 a, const quint32 b) const {
+		if (m_store.status(a) < m_store.status(b)) return true;
+		if (m_store.status(a) == m_store.status(b)) {
+			return a < b;
 		}
 		return false;
 	}
+	const PackageStore& m_store;
 };
 
 struct TSort2 {
-	bool operator()(const PackageRepository::PackageData* a, const PackageRepository::PackageData* b) const {
-		const int cmp = Pacman::rpmvercmp(a->version.toLatin1().data(), b->version.toLatin1().data());
+	TSort2(const PackageStore& store) : m_store(store) {}
+	bool operator()(const quint32 a, const quint32 b) const {
+		const int cmp = m_store.compareVersions(a, b);
 		if (cmp < 0) return true;
 		if (cmp == 0) {
-			return a->name < b->name;
+			return a < b;
 		}
 		return false;
 	}
+	const PackageStore& m_store;
 };
 
 struct TSort3 {
-	bool operator()(const PackageRepository::PackageData* a, const PackageRepository::PackageData* b) const {
-		if (a->repository < b->repository) return true;
-		if (a->repository == b->repository) {
-			return a->name < b->name;
+	TSort3(const PackageStore& store) : m_store(store) {}
+	bool operator()(const quint32 a, const quint32 b) const {
+		if (m_store.repositoryId(a) < m_store.repositoryId(b)) return true;
+		if (m_store.repositoryId(a) == m_store.repositoryId(b)) {
+			return a < b;
 		}
 		return false;
 	}
+	const PackageStore& m_store;
 };
 
+/*
+ * popularity (votes) is only known for AUR packages, which are not loaded, all packages rank equal
+ */
 struct TSort4 {
-	bool operator()(const PackageRepository::PackageData* a, const PackageRepository::PackageData* b) const {
-//	if (a->popularity > b->popularity) return true;
-//	if (a->popularity == b->popularity) {
-		return a->name < b->name;
-//	}
-//	return false;
+	bool operator()(const quint32 a, const quint32 b) const {
+		return a < b;
 	}
 };
 
-void PackageModel::sort()
+/**
+ * @brief sorts %ids (ordered by name) by %column
+ */
+void PackageModel::sortRows(const PackageStore& store, const int column, PackageRepository::TListOfIds& ids)
 {
-	switch (m_sortColumn) {
-	case ctn_PACKAGE_NAME_COLUMN:
-		m_columnSortedlistOfPackages = m_listOfPackages;
-		return;
+	switch (column) {
 	case ctn_PACKAGE_ICON_COLUMN:
-		qSort(m_columnSortedlistOfPackages.begin(), m_columnSortedlistOfPackages.end(), TSort0());
+		qSort(ids.begin(), ids.end(), TSort0(store));
 		return;
 	case ctn_PACKAGE_VERSION_COLUMN:
-		qSort(m_columnSortedlistOfPackages.begin(), m_columnSortedlistOfPackages.end(), TSort2());
+		qSort(ids.begin(), ids.end(), TSort2(store));
 		return;
 	case ctn_PACKAGE_REPOSITORY_COLUMN:
-		qSort(m_columnSortedlistOfPackages.begin(), m_columnSortedlistOfPackages.end(), TSort3());
+		qSort(ids.begin(), ids.end(), TSort3(store));
 		return;
 	case ctn_PACKAGE_POPULARITY_COLUMN:
-		qSort(m_columnSortedlistOfPackages.begin(), m_columnSortedlistOfPackages.end(), TSort4());
+		qSort(ids.begin(), ids.end(), TSort4());
 		return;
+	case ctn_PACKAGE_NAME_COLUMN:
 	default:
 		return;
 	}
@@ -378,7 +627,7 @@ int PackageModel::transformRowIndex(int row, int rowCount) const
 	return -1;
 }
 
-PackageItem*PackageModel::createDummyRoot()
+PackageItem*PackageModel::createDummyRoot() const
 {
-	return new PackageItem(PackageItem::TPkgVec(), PackageItem::DEPENDS_ON);
+	return new PackageItem(m_packageRepo, PackageItem::TIdRange(nullptr, nullptr), PackageItem::DEPENDS_ON);
 }
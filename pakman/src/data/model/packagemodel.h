@@ -21,7 +21,10 @@
 #ifndef PACMANQT_PACKAGEMODEL_H
 #define PACMANQT_PACKAGEMODEL_H
 
+#include <atomic>
+#include <memory>
 #include <QAbstractItemModel>
+#include <QFutureWatcher>
 #include <QIcon>
 
 #include "src/commands/pacman.h"
@@ -43,6 +46,7 @@ public:
 	static const int ctn_PACKAGE_POPULARITY_COLUMN  = 4;
 	// Pseudo Column indices for additional filter criterias
 	static const int ctn_PACKAGE_DESCRIPTION_FILTER_NO_COLUMN = 5;
+	static const int ctn_PACKAGE_FILE_FILTER_NO_COLUMN        = 6;
 
 public:
 	enum EDisplayMode {
@@ -51,11 +55,19 @@ public:
 
 public:
 	explicit PackageModel(const PackageRepository& repo, QObject* parent = 0);
+	virtual ~PackageModel();
 
 signals:
+	/**
+	 * @brief the rows of a finished filter or sort evaluation have been applied
+	 */
+	void rowsEvaluated();
 
 public slots:
 
+private slots:
+	void evaluationFinished();
+
 
 	// QAbstractItemModel interface
 public:
@@ -83,26 +95,58 @@ public:
 public:
 	void switchDisplayMode(EDisplayMode newMode);
 	void setNewFilter(std::unique_ptr<IPackageFilter>&& filter);
+	/**
+	 * @brief applies %fnc to the current filter, the rows are filtered again in a worker thread
+	 *
+	 * a refined filter only filters the current rows again
+	 */
 	template<class Functor>
 	void syncFilterChange(Functor fnc) {
-		beginResetRepository(PackageRepository::eResetRepository);
 		fnc(*m_filter);
-		endResetRepository(PackageRepository::eResetRepository);
+		requestEvaluation(eRowsUnfiltered);
 	}
 
 private:
+	/**
+	 * @brief state of the current rows, ordered by the work needed to bring them up to date
+	 */
+	enum ERowsState {
+		eRowsValid,
+		eRowsUnsorted,   // the sort column changed
+		eRowsUnfiltered, // the filter changed (possibly a refinement of the current rows)
+		eRowsInvalid     // the repository changed
+	};
+
+	/**
+	 * @brief a filter and sort run of the rows in a worker thread
+	 */
+	struct Evaluation {
+		quint32                         generation; // superseded if != m_generation
+		std::unique_ptr<IPackageFilter> filter;     // copy of m_filter, nullptr if the rows are only sorted
+		bool                            refine;     // filter the current rows instead of the base package list
+		int                             sortColumn;
+		PackageRepository::TListOfIds   rows;       // current rows (refine, sort) and result ordered by name
+		PackageRepository::TListOfIds   sortedRows; // result sorted by sortColumn
+		bool                            completed;
+	};
+
 	PackageItem& getPackageItem(const QModelIndex& index) const; // for use in tree models only (e.g. depends)
 	const QIcon& getIconFor(const PackageRepository::PackageData& package) const;
-	void sort();
+	void requestEvaluation(const ERowsState state);
+	void startPendingEvaluation();
+	void cancelEvaluation();
+	void evaluate(Evaluation*const evaluation) const;
+	bool changeRows(const PackageRepository::TListOfIds& rows);
+	static void sortRows(const PackageStore& store, const int column, PackageRepository::TListOfIds& ids);
 private:
 	int transformRowIndex(int row, int rowCount) const;
-	static PackageItem* createDummyRoot();
+	PackageItem* createDummyRoot() const;
 
 
 private:
 	const PackageRepository&           m_packageRepo;
-	PackageRepository::TListOfPackages m_listOfPackages;             // should be provided sorted by name (by repo)
-	PackageRepository::TListOfPackages m_columnSortedlistOfPackages; // sorted by column
+	PackageRepository::TListOfIds      m_listOfPackages;             // should be provided sorted by name (by repo)
+	PackageRepository::TListOfIds      m_columnSortedlistOfPackages; // sorted by column
 
 	EDisplayMode                m_displayMode;
 	std::auto_ptr<PackageItem>  m_rootItem; // dummy for FLAT mode
@@ -110,8 +154,15 @@ private:
 	// Sort attributes
 	Qt::SortOrder m_sortOrder;
 	int           m_sortColumn;
+	int           m_rowsSortColumn; // of m_columnSortedlistOfPackages
 	// Filter attributes
 	std::unique_ptr<IPackageFilter> m_filter;
+	// Evaluation (at most one running, the latest request is pending)
+	ERowsState                  m_rowsState;
+	std::atomic<quint32>        m_generation; // of the latest request
+	std::unique_ptr<Evaluation> m_runningEvaluation;
+	std::unique_ptr<Evaluation> m_pendingEvaluation;
+	QFutureWatcher<void>        m_evaluationWatch;
 
 	// Cache
 	QIcon   m_iconNotInstalled;
@@ -0,0 +1,88 @@
+/*
+* This file is part of pakman, an open-source GUI for pacman.
+* Copyright (C) 2014 Thomas Binkau
+*
+* This program is free software; you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation; either version 2 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+*
+*/
+
+#include "packagearena.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+
+
+PackageArena::PackageArena(const std::size_t blockSize)
+	: m_blockSize(blockSize), m_current(nullptr), m_end(nullptr)
+{
+}
+
+PackageArena::~PackageArena()
+{
+	release();
+}
+
+void PackageArena::reserve(const std::size_t bytes)
+{
+	if (static_cast<std::size_t>(m_end - m_current) < bytes)
+		addBlock(bytes);
+}
+
+void* PackageArena::allocate(const std::size_t size, const std::size_t alignment)
+{
+	assert(alignment != 0 && (alignment & (alignment - 1)) == 0);
+
+	std::uintptr_t address = reinterpret_cast<std::uintptr_t>(m_current);
+	std::size_t padding = (alignment - (address & (alignment - 1))) & (alignment - 1);
+	if (m_current == nullptr || static_cast<std::size_t>(m_end - m_current) < padding + size) {
+		addBlock(size + alignment);
+		address = reinterpret_cast<std::uintptr_t>(m_current);
+		padding = (alignment - (address & (alignment - 1))) & (alignment - 1);
+	}
+
+	char*const result = m_current + padding;
+	m_current = result + size;
+	m_statistics.used += padding + size;
+	++m_statistics.allocations;
+	return result;
+}
+
+void PackageArena::release()
+{
+	for (std::vector<char*>::const_iterator it = m_blocks.begin(); it != m_blocks.end(); ++it) {
+		delete[] *it;
+	}
+	m_blocks.clear();
+	m_current = nullptr;
+	m_end = nullptr;
+	m_statistics = Statistics();
+}
+
+const PackageArena::Statistics& PackageArena::getStatistics() const
+{
+	return m_statistics;
+}
+
+void PackageArena::addBlock(const std::size_t minimumSize)
+{
+	const std::size_t size = std::max(m_blockSize, minimumSize);
+	char*const block = new char[size];
+	m_blocks.push_back(block);
+	m_current = block;
+	m_end = block + size;
+	++m_statistics.blocks;
+	m_statistics.reserved += size;
+}
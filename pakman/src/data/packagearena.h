@@ -0,0 +1,87 @@
+/*
+* This file is part of pakman, an open-source GUI for pacman.
+* Copyright (C) 2014 Thomas Binkau
+*
+* This program is free software; you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation; either version 2 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+*
+*/
+
+#ifndef PACKAGEARENA_H
+#define PACKAGEARENA_H
+
+#include <cstddef>
+#include <new>
+#include <utility>
+#include <vector>
+
+
+/**
+ * @brief Bump allocator for all data of one generation of packages
+ *
+ * Memory is handed out from large blocks and only released as a whole.
+ * Destructors of the created objects are NOT called by the arena, the owner
+ * has to do this before calling release().
+ */
+class PackageArena
+{
+public:
+	struct Statistics {
+		std::size_t blocks;      // number of blocks allocated
+		std::size_t reserved;    // bytes allocated from the heap
+		std::size_t used;        // bytes handed out (including alignment padding)
+		std::size_t allocations; // number of allocations
+
+		Statistics()
+			: blocks(0), reserved(0), used(0), allocations(0)
+		{}
+	};
+
+public:
+	explicit PackageArena(const std::size_t blockSize = 64 * 1024);
+	~PackageArena();
+
+	/**
+	 * @brief makes sure the next %bytes can be allocated from a single block
+	 */
+	void reserve(const std::size_t bytes);
+	void* allocate(const std::size_t size, const std::size_t alignment);
+
+	template <typename T, typename... TArgs>
+	T* create(TArgs&&... args) {
+		return new (allocate(sizeof(T), alignof(T))) T(std::forward<TArgs>(args)...);
+	}
+
+	/**
+	 * @brief releases all blocks in one shot, all objects created before must be destroyed already
+	 */
+	void release();
+
+	const Statistics& getStatistics() const;
+
+private:
+	PackageArena(const PackageArena&) = delete;
+	PackageArena& operator=(const PackageArena&) = delete;
+
+	void addBlock(const std::size_t minimumSize);
+
+private:
+	const std::size_t  m_blockSize;
+	std::vector<char*> m_blocks;
+	char*              m_current;
+	char*              m_end;
+	Statistics         m_statistics;
+};
+
+#endif // PACKAGEARENA_H
@@ -0,0 +1,100 @@
+/*
+* This file is part of pakman, an open-source GUI for pacman.
+* Copyright (C) 2014 Thomas Binkau
+*
+* This program is free software; you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation; either version 2 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+*
+*/
+
+#include "packagebitset.h"
+
+#include <cassert>
+
+
+PackageBitset::PackageBitset()
+	: m_size(0)
+{
+}
+
+PackageBitset::PackageBitset(const quint32 size)
+	: m_size(size), m_words((size + 63) / 64, 0)
+{
+}
+
+PackageBitset::PackageBitset(const quint32 size, const TIdList& ids)
+	: m_size(size), m_words((size + 63) / 64, 0)
+{
+	for (TIdList::const_iterator it = ids.begin(); it != ids.end(); ++it) {
+		assert(*it < size);
+		set(*it);
+	}
+}
+
+void PackageBitset::fill(const bool value)
+{
+	m_words.assign(m_words.size(), value ? ~quint64(0) : 0);
+	// keep the bits behind the last id cleared
+	if (value && (m_size & 63) != 0)
+		m_words.back() = (quint64(1) << (m_size & 63)) - 1;
+}
+
+PackageBitset& PackageBitset::operator|=(const PackageBitset& other)
+{
+	assert(m_size == other.m_size);
+	for (std::size_t x = 0; x < m_words.size(); ++x) {
+		m_words[x] |= other.m_words[x];
+	}
+	return *this;
+}
+
+PackageBitset& PackageBitset::operator&=(const PackageBitset& other)
+{
+	assert(m_size == other.m_size);
+	for (std::size_t x = 0; x < m_words.size(); ++x) {
+		m_words[x] &= other.m_words[x];
+	}
+	return *this;
+}
+
+PackageBitset& PackageBitset::subtract(const PackageBitset& other)
+{
+	assert(m_size == other.m_size);
+	for (std::size_t x = 0; x < m_words.size(); ++x) {
+		m_words[x] &= ~other.m_words[x];
+	}
+	return *this;
+}
+
+quint32 PackageBitset::count() const
+{
+	quint32 result = 0;
+	for (std::vector<quint64>::const_iterator it = m_words.begin(); it != m_words.end(); ++it) {
+		result += __builtin_popcountll(*it);
+	}
+	return result;
+}
+
+void PackageBitset::toIds(TIdList& ids) const
+{
+	ids.clear();
+	ids.reserve(count());
+	for (std::size_t x = 0; x < m_words.size(); ++x) {
+		quint64 word = m_words[x];
+		while (word != 0) {
+			ids.push_back(x * 64 + __builtin_ctzll(word));
+			word &= word - 1;
+		}
+	}
+}
@@ -0,0 +1,75 @@
+/*
+* This file is part of pakman, an open-source GUI for pacman.
+* Copyright (C) 2014 Thomas Binkau
+*
+* This program is free software; you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation; either version 2 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+*
+*/
+
+#ifndef PACKAGEBITSET_H
+#define PACKAGEBITSET_H
+
+#include <vector>
+#include <QtGlobal>
+
+
+/**
+ * @brief Dense set of package ids (see PackageStore), one bit per package
+ *
+ * All set operations work on 64 bit words, both operands must have the same size.
+ */
+class PackageBitset
+{
+public:
+	typedef std::vector<quint32> TIdList;
+
+public:
+	PackageBitset();
+	/**
+	 * @param size (number of packages, all bits are cleared)
+	 */
+	explicit PackageBitset(const quint32 size);
+	PackageBitset(const quint32 size, const TIdList& ids);
+
+	inline quint32 size() const {
+		return m_size;
+	}
+	inline bool test(const quint32 id) const {
+		return (m_words[id >> 6] >> (id & 63)) & 1;
+	}
+	inline void set(const quint32 id) {
+		m_words[id >> 6] |= quint64(1) << (id & 63);
+	}
+
+	void fill(const bool value);
+	PackageBitset& operator|=(const PackageBitset& other);
+	PackageBitset& operator&=(const PackageBitset& other);
+	/**
+	 * @brief removes all ids of %other
+	 */
+	PackageBitset& subtract(const PackageBitset& other);
+
+	quint32 count() const;
+	/**
+	 * @brief replaces the content of %ids by all ids in this set (ascending)
+	 */
+	void toIds(TIdList& ids) const;
+
+private:
+	quint32              m_size;
+	std::vector<quint64> m_words;
+};
+
+#endif // PACKAGEBITSET_H
@@ -22,6 +22,8 @@
 #define PACKAGEDATA_H
 
 #include <QString>
+#include <QStringList>
+#include <QHash>
 #include <QDateTime>
 
 
@@ -51,6 +53,9 @@ struct PackageListData {
 	QString outatedVersion; // may contain alphanumeric and _.-
 //	int    popularity;    // votes
 	PackageStatus status;   // see description of PackageStatus
+	QStringList groups;     // package groups, e.g. "(lxde)" of "-Ss"
+	QStringList depends;    // dependencies with optional version restriction, e.g. "glibc>=2.19"
+	QStringList provides;   // provided (virtual) packages with optional version, e.g. "sh=4.3"
 
 	PackageListData(QString n, QString r, QString v, QString d, PackageStatus pkgStatus, QString outVersion="")
 		: name(n), repository(r), version(v), description(d), outatedVersion(outVersion.trimmed()),
@@ -58,6 +63,20 @@ struct PackageListData {
 	{}
 };
 
+/**
+ * @brief For intermediate data storage / transport of the installation state of a package
+ */
+struct LocalPackageData {
+	QString version;
+	bool    explicitlyInstalled; // false if installed as dependency
+	bool    required;            // true if (optionally) required by another installed package
+
+	LocalPackageData()
+		: explicitlyInstalled(false), required(false)
+	{}
+};
+typedef QHash<QString, LocalPackageData> TLocalPackages; // name -> installation state
+
 //TODO more documentation
 /**
  * @brief For intermediate data storage / transport of package details
@@ -0,0 +1,87 @@
+/*
+* This file is part of pakman, an open-source GUI for pacman.
+* Copyright (C) 2014 Thomas Binkau
+*
+* This program is free software; you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation; either version 2 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+*
+*/
+
+#include "packagedetailcache.h"
+
+#include <QRegExp>
+#include <QStringList>
+
+
+PackageDetailCache::PackageDetailCache()
+	: m_stamp(0)
+{
+}
+
+void PackageDetailCache::reset(const qint64 stamp, std::unique_ptr<QList<PackageDetailData>>&& syncDetails,
+                               std::unique_ptr<QList<PackageDetailData>>&& localDetails)
+{
+	// build the indices unsynchronized
+	QHash<QString, int> syncIndex;
+	syncIndex.reserve(syncDetails->size() * 2);
+	for (int x = 0; x < syncDetails->size(); ++x) {
+		const PackageDetailData& pkg = syncDetails->at(x);
+		syncIndex.insert(pkg.repository + "/" + pkg.name, x);
+		if (syncIndex.contains(pkg.name) == false) // "-Si name" delivers the first repository only
+			syncIndex.insert(pkg.name, x);
+	}
+	QHash<QString, int> localIndex;
+	localIndex.reserve(localDetails->size());
+	for (int x = 0; x < localDetails->size(); ++x) {
+		localIndex.insert(localDetails->at(x).name, x);
+	}
+
+	std::lock_guard<std::mutex> lock(m_sync);
+	m_stamp = stamp;
+	m_syncDetails  = std::move(syncDetails);
+	m_localDetails = std::move(localDetails);
+	m_syncIndex.swap(syncIndex);
+	m_localIndex.swap(localIndex);
+}
+
+bool PackageDetailCache::isValid(const qint64 stamp) const
+{
+	std::lock_guard<std::mutex> lock(m_sync);
+	return m_stamp != 0 && m_stamp == stamp;
+}
+
+std::unique_ptr<QList<PackageDetailData>> PackageDetailCache::find(const qint64 stamp, const QString& pkgNames,
+                                                                   const bool installedPackage) const
+{
+	const QStringList names = pkgNames.split(QRegExp("\\s"), QString::SkipEmptyParts);
+
+	std::lock_guard<std::mutex> lock(m_sync);
+	if (m_stamp == 0 || m_stamp != stamp)
+		return std::unique_ptr<QList<PackageDetailData>>();
+
+	const QList<PackageDetailData>& details = installedPackage ? *m_localDetails : *m_syncDetails;
+	if (names.isEmpty()) // all packages
+		return std::unique_ptr<QList<PackageDetailData>>(new QList<PackageDetailData>(details));
+
+	const QHash<QString, int>& index = installedPackage ? m_localIndex : m_syncIndex;
+	std::unique_ptr<QList<PackageDetailData>> res(new QList<PackageDetailData>());
+	res->reserve(names.size());
+	foreach (const QString& name, names) {
+		QHash<QString, int>::const_iterator it = index.find(name);
+		if (it == index.end())
+			return std::unique_ptr<QList<PackageDetailData>>();
+		res->append(details.at(*it));
+	}
+	return res;
+}
@@ -0,0 +1,75 @@
+/*
+* This file is part of pakman, an open-source GUI for pacman.
+* Copyright (C) 2014 Thomas Binkau
+*
+* This program is free software; you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation; either version 2 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+*
+*/
+
+#ifndef PACKAGEDETAILCACHE_H
+#define PACKAGEDETAILCACHE_H
+
+#include <memory>
+#include <mutex>
+#include <QHash>
+#include <QList>
+#include <QString>
+
+#include "src/data/packagedata.h"
+
+
+/**
+ * @brief Indexed storage of the package details of all sync and all installed packages
+ *
+ * The cache is filled in bulk and tagged with the modification stamp of the
+ * pacman databases it was read from, it will not answer once the databases
+ * have changed. All methods are thread safe.
+ */
+class PackageDetailCache
+{
+public:
+	PackageDetailCache();
+
+	/**
+	 * @brief replaces the cached details
+	 * @param stamp         (database modification stamp at the time of reading)
+	 * @param syncDetails   (output of "-Si" for all packages, in repository order)
+	 * @param localDetails  (output of "-Qi" for all packages)
+	 */
+	void reset(const qint64 stamp, std::unique_ptr<QList<PackageDetailData>>&& syncDetails,
+	           std::unique_ptr<QList<PackageDetailData>>&& localDetails);
+	/**
+	 * @brief true if the cache was filled from databases with the modification stamp %stamp
+	 */
+	bool isValid(const qint64 stamp) const;
+	/**
+	 * @brief same semantics as Pacman::getPackageDetails
+	 * @param pkgNames (plain or repo/name notation, separated by whitespace)
+	 * @return nullptr if the cache is not valid for %stamp or one of the packages is unknown
+	 */
+	std::unique_ptr<QList<PackageDetailData>> find(const qint64 stamp, const QString& pkgNames,
+	                                               const bool installedPackage) const;
+
+private:
+	mutable std::mutex m_sync;
+	qint64             m_stamp; // 0 == empty
+
+	std::unique_ptr<QList<PackageDetailData>> m_syncDetails;
+	std::unique_ptr<QList<PackageDetailData>> m_localDetails;
+	QHash<QString, int> m_syncIndex;  // repo/name and name (first repository) -> index in m_syncDetails
+	QHash<QString, int> m_localIndex; // name -> index in m_localDetails
+};
+
+#endif // PACKAGEDETAILCACHE_H
@@ -0,0 +1,90 @@
+/*
+* This file is part of pakman, an open-source GUI for pacman.
+* Copyright (C) 2014 Thomas Binkau
+*
+* This program is free software; you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation; either version 2 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+*
+*/
+
+#include "packagenameindex.h"
+
+#include "src/data/packagestore.h"
+
+
+PackageNameIndex::PackageNameIndex()
+	: m_store(nullptr), m_slots(1, 0), m_mask(0)
+{
+}
+
+void PackageNameIndex::reset(const PackageStore& store)
+{
+	m_store = &store;
+	m_entries.clear();
+
+	// one entry per distinct name (equal names are adjacent)
+	const quint32 count = store.size();
+	for (quint32 id = 0; id < count; ++id) {
+		if (m_entries.empty() == false && store.nameEquals(m_entries.back().firstId, store.nameData(id), store.nameLength(id))) {
+			m_entries.back().endId = id + 1;
+			continue;
+		}
+		Entry entry;
+		entry.hash    = hash(store.nameData(id), store.nameLength(id));
+		entry.firstId = id;
+		entry.endId   = id + 1;
+		m_entries.push_back(entry);
+	}
+
+	// load factor <= 0.5
+	quint32 capacity = 16;
+	while (capacity < m_entries.size() * 2) {
+		capacity *= 2;
+	}
+	m_mask = capacity - 1;
+	m_slots.assign(capacity, 0);
+	for (quint32 x = 0; x < m_entries.size(); ++x) {
+		quint32 slot = m_entries[x].hash & m_mask;
+		while (m_slots[slot] != 0) {
+			slot = (slot + 1) & m_mask;
+		}
+		m_slots[slot] = x + 1;
+	}
+}
+
+PackageNameIndex::TIdRange PackageNameIndex::find(const QString& name) const
+{
+	if (m_store == nullptr)
+		return TIdRange(0, 0);
+
+	const quint32 h = hash(name.constData(), name.size());
+	for (quint32 slot = h & m_mask; m_slots[slot] != 0; slot = (slot + 1) & m_mask) {
+		const Entry& entry = m_entries[m_slots[slot] - 1];
+		if (entry.hash == h && m_store->nameEquals(entry.firstId, name.constData(), name.size()))
+			return TIdRange(entry.firstId, entry.endId);
+	}
+	return TIdRange(0, 0);
+}
+
+/**
+ * @brief FNV-1a over the utf16 code units
+ */
+quint32 PackageNameIndex::hash(const QChar* data, const int length)
+{
+	quint32 h = 2166136261u;
+	for (int x = 0; x < length; ++x) {
+		h = (h ^ data[x].unicode()) * 16777619u;
+	}
+	return h;
+}
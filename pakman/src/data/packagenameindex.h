@@ -0,0 +1,76 @@
+/*
+* This file is part of pakman, an open-source GUI for pacman.
+* Copyright (C) 2014 Thomas Binkau
+*
+* This program is free software; you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation; either version 2 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+*
+*/
+
+#ifndef PACKAGENAMEINDEX_H
+#define PACKAGENAMEINDEX_H
+
+#include <utility>
+#include <vector>
+#include <QChar>
+#include <QString>
+
+class PackageStore;
+
+
+/**
+ * @brief Open addressing hash table from a package name to the ids of all packages with this name
+ *
+ * Relies on the ordering of the PackageStore: packages are sorted by name (stable, so packages with the
+ * same name keep the order of the repositories in pacman.conf), thus all packages of one name form a
+ * contiguous range of ids ordered by repository priority.
+ */
+class PackageNameIndex
+{
+public:
+	typedef std::pair<quint32, quint32> TIdRange; // [first, second)
+
+public:
+	PackageNameIndex();
+
+	/**
+	 * @brief rebuilds the index, %store must outlive the index (or the next reset)
+	 */
+	void reset(const PackageStore& store);
+	/**
+	 * @return empty range if there is no package called %name
+	 */
+	TIdRange find(const QString& name) const;
+
+	inline std::size_t countNames() const {
+		return m_entries.size();
+	}
+
+private:
+	struct Entry {
+		quint32 hash;
+		quint32 firstId;
+		quint32 endId;
+	};
+
+	static quint32 hash(const QChar* data, const int length);
+
+private:
+	const PackageStore*  m_store;
+	std::vector<Entry>   m_entries;
+	std::vector<quint32> m_slots; // index in m_entries + 1, 0 == empty slot
+	quint32              m_mask;
+};
+
+#endif // PACKAGENAMEINDEX_H
@@ -20,6 +20,7 @@
 
 #include "packagerepository.h"
 
+#include <algorithm>
 #include <cassert>
 #include <iostream>
 
@@ -29,9 +30,19 @@
 
 #include "src/strconstants.h"
 #include "src/commands/pacman.h"
+#include "src/data/dependencygraph.h"
+#include "src/data/packagearena.h"
+#include "src/data/packagesnapshot.h"
+#include "src/data/packagestore.h"
+#include "src/data/providesindex.h"
+#include "src/data/trigramindex.h"
 
 
 PackageRepository::PackageRepository()
+	: m_store(new PackageStore()), m_provides(new ProvidesIndex()), m_dependencies(new DependencyGraph()),
+	  m_descriptions(new TrigramIndex()),
+	  m_syncArena(new PackageArena()), m_foreignArena(new PackageArena()),
+	  m_retiredGenerations(0), m_databaseStamp(0)
 {
 }
 
@@ -41,11 +52,10 @@ PackageRepository::~PackageRepository()
 	for (std::vector<Group*>::const_iterator it = m_listOfGroups.begin(); it != m_listOfGroups.end(); ++it) {
 		if (*it != NULL) delete *it;
 	}
-	// delete items in list
+	// destroy items in list, their memory is owned by the arenas
 	for (TListOfPackages::const_iterator it = m_listOfPackages.begin(); it != m_listOfPackages.end(); ++it) {
-		if (*it != NULL) delete *it;
+		if (*it != NULL) (*it)->~PackageData();
 	}
-
 }
 
 void PackageRepository::registerDependency(PackageRepository::IDependency &depends)
@@ -72,6 +82,9 @@ struct BeginResetModel {
 	const PackageRepository::EResetType m_type;
 };
 
+/**
+ * @brief order by name, must be used with a stable sort to keep the order of repositories (pacman.conf)
+ */
 struct TSort {
 	bool operator()(const PackageRepository::PackageData* a, const PackageRepository::PackageData* b) const {
 		return a->name < b->name;
@@ -91,52 +104,58 @@ struct EndResetModel {
 };
 
 void PackageRepository::setData(const QList<PackageListData>*const listOfPackages,
-                                const QSet<QString>& unrequiredPackages,
-                                const QSet<QString>& explicitlyInstalledPackages)
+                                const TLocalPackages& localPackages)
 {
 //  std::cout << "received new package list" << std::endl;
 
 	std::for_each(m_dependingModels.begin(), m_dependingModels.end(), BeginResetModel(eResetRepository));
 
-	// delete items in groups list
-	for (std::vector<Group*>::const_iterator it = m_listOfGroups.begin(); it != m_listOfGroups.end(); ++it) {
-		if (*it != nullptr) (*it)->invalidateList();
-	}
-	// delete items in list
-	for (TListOfPackages::const_iterator it = m_listOfPackages.begin(); it != m_listOfPackages.end(); ++it) {
-		if (*it != nullptr) delete *it;
-	}
-	m_listOfPackages.clear();
+	// retire all packages (foreign packages are replaced too)
+	retireAllGenerations();
 
+	QMap<QString, TListOfPackages> groupMembers; // sorted by group name
+	m_repositoryOrder.clear();
 	m_listOfPackages.reserve(listOfPackages->size());
+	m_syncArena->reserve(listOfPackages->size() * sizeof(PackageData));
 	for (QList<PackageListData>::const_iterator it = listOfPackages->begin(); it != listOfPackages->end(); ++it) {
-		PackageData*const data = new PackageData(*it, unrequiredPackages.contains(it->name) == false, false,
-		                                         explicitlyInstalledPackages.contains(it->name) == true);
+		// packages which are not installed are required by definition (consistent with "-Qt")
+		TLocalPackages::const_iterator local = localPackages.find(it->name);
+		const bool installed = local != localPackages.end();
+		PackageData*const data = m_syncArena->create<PackageData>(*it, installed == false || local->required, false,
+		                                                          installed && local->explicitlyInstalled);
 		m_listOfPackages.push_back(data);
-		m_setOfRepos << data->repository;
+		// the list is in order of pacman.conf
+		if (m_repositoryOrder.contains(it->repository) == false) m_repositoryOrder.append(it->repository);
+		foreach (const QString& group, it->groups) {
+			groupMembers[group].push_back(data);
+		}
 	}
 
-	qSort(m_listOfPackages.begin(), m_listOfPackages.end(), TSort());
+	std::stable_sort(m_listOfPackages.begin(), m_listOfPackages.end(), TSort());
+	rebuildStore();
+	rebuildGroups(groupMembers);
 	std::for_each(m_dependingModels.begin(), m_dependingModels.end(), EndResetModel(eResetRepository));
 }
 
 void PackageRepository::setAURData(/*inout*/QList<PackageListData>*const listOfForeignPackages,
-                                   const QSet<QString>& unrequiredPackages,
+                                   const TLocalPackages& localPackages,
                                    const QMap<QString, PackageListData>*const aurPackageData)
 {
 	//  std::cout << "received new foreign package list" << std::endl;
 
 	std::for_each(m_dependingModels.begin(), m_dependingModels.end(), BeginResetModel(eResetRepository));
 
-	// delete yaourt items in list
-	for (TListOfPackages::iterator it = m_listOfPackages.begin(); it != m_listOfPackages.end(); ++it) {
-		if (*it != NULL && (*it)->managedByYaourt) {
-			delete *it;
-			it = m_listOfPackages.erase(it);
-		}
+	// group members are never managed by yaourt, they will survive (with a new id)
+	TListOfPackages previousPackages(m_listOfPackages);
+	for (TListOfPackages::iterator it = previousPackages.begin(); it != previousPackages.end(); ++it) {
+		if ((*it)->managedByYaourt) *it = nullptr;
 	}
 
+	// retire the previous foreign generation
+	retireGeneration(*m_foreignArena, true);
+
 	m_listOfPackages.reserve(m_listOfPackages.size() + listOfForeignPackages->size());
+	m_foreignArena->reserve(listOfForeignPackages->size() * sizeof(PackageData));
 	for (QList<PackageListData>::iterator it = listOfForeignPackages->begin();
 			 it != listOfForeignPackages->end(); ++it)
 	{
@@ -150,122 +169,127 @@ void PackageRepository::setAURData(/*inout*/QList<PackageListData>*const listOfF
 				it->status = epkg_FOREIGN_OUTDATED;
 			}
 		}
-		// explicitly installed is always true for AUR packages
-		//TODO: this is not true, AUR packages can be installed as dep, e.g. when being dropped to AUR later on
-		PackageData*const pkg = new PackageData(*it, unrequiredPackages.contains(it->name) == false, true, true);
+		// AUR packages can be installed as dependency too, e.g. when being dropped to AUR later on
+		TLocalPackages::const_iterator local = localPackages.find(it->name);
+		const bool installed = local != localPackages.end();
+		PackageData*const pkg = m_foreignArena->create<PackageData>(*it, installed == false || local->required, true,
+		                                                            installed == false || local->explicitlyInstalled);
 		m_listOfPackages.push_back(pkg);
-		m_setOfRepos << pkg->repository;
 	}
 
-	qSort(m_listOfPackages.begin(), m_listOfPackages.end(), TSort());
+	std::stable_sort(m_listOfPackages.begin(), m_listOfPackages.end(), TSort());
+	rebuildStore();
+
+	// translate the ids of all group members
+	TListOfIds newIds(previousPackages.size());
+	for (std::size_t x = 0; x < previousPackages.size(); ++x) {
+		if (previousPackages[x] != nullptr) newIds[x] = previousPackages[x]->getId();
+	}
+	for (std::vector<Group*>::const_iterator it = m_listOfGroups.begin(); it != m_listOfGroups.end(); ++it) {
+		if (*it != nullptr) (*it)->remapPackages(newIds, m_store->size());
+	}
 	std::for_each(m_dependingModels.begin(), m_dependingModels.end(), EndResetModel(eResetRepository));
 }
 
-/**
- * @brief if the repository groups differ from %listOfGroups they will be reset
- * @param listOfGroups == group names
- */
-void PackageRepository::checkAndSetGroups(const QStringList& listOfGroups)
+bool PackageRepository::restoreSnapshot(const QString& fileName, const qint64 stamp)
 {
-	if (memberListOfGroupsEquals(listOfGroups) == false) {
-		std::for_each(m_dependingModels.begin(), m_dependingModels.end(), BeginResetModel(eResetGroupList));
-		for (std::vector<Group*>::const_iterator it = m_listOfGroups.begin(); it != m_listOfGroups.end(); ++it) {
-			if (*it != NULL) delete *it;
-		}
-		m_listOfGroups.clear();
-
-		for (QStringList::const_iterator it = listOfGroups.begin(); it != listOfGroups.end(); ++it) {
-			m_listOfGroups.push_back(new Group(*it));
-		}
-		std::for_each(m_dependingModels.begin(), m_dependingModels.end(), EndResetModel(eResetGroupList));
-	}
-}
+	PackageSnapshot::Reader snapshot(fileName);
+	if (snapshot.open(stamp) == false)
+		return false;
 
-struct TComp {
-	bool operator()(const PackageRepository::PackageData* a, const QString& b) const {
-		return a->name < b;
+	// packages (stored in sorted order)
+	std::for_each(m_dependingModels.begin(), m_dependingModels.end(), BeginResetModel(eResetRepository));
+	retireAllGenerations();
+
+	m_repositoryOrder = snapshot.repositories();
+	m_listOfPackages.reserve(snapshot.packageCount());
+	for (quint32 x = 0; x < snapshot.packageCount(); ++x) {
+		const PackageSnapshot::PackageRecord& record = snapshot.package(x);
+		PackageListData pkg(snapshot.string(record.name), snapshot.string(record.repository),
+		                    snapshot.string(record.version), snapshot.string(record.description),
+		                    static_cast<PackageStatus>(record.status), snapshot.string(record.outdatedVersion));
+		pkg.depends  = snapshot.depends(record);
+		pkg.provides = snapshot.provides(record);
+		const bool managedByYaourt = record.flags & PackageSnapshot::eFlagManagedByYaourt;
+		PackageArena& arena = managedByYaourt ? *m_foreignArena : *m_syncArena;
+		PackageData*const data = arena.create<PackageData>(pkg, record.flags & PackageSnapshot::eFlagRequired,
+		                                                   managedByYaourt,
+		                                                   record.flags & PackageSnapshot::eFlagExplicitlyInstalled);
+		m_listOfPackages.push_back(data);
 	}
-	bool operator()(const QString& b, const PackageRepository::PackageData* a) const {
-		return b < a->name;
+	rebuildStore();
+
+	// groups
+	deleteGroups();
+	for (quint32 x = 0; x < snapshot.groupCount(); ++x) {
+		const PackageSnapshot::GroupRecord& record = snapshot.group(x);
+		const quint32*const members = snapshot.members(record);
+		addGroup(new Group(snapshot.string(record.name), TListOfIds(members, members + record.memberCount),
+		                   m_store->size()));
 	}
-};
+	std::for_each(m_dependingModels.begin(), m_dependingModels.end(), EndResetModel(eResetRepository));
 
-/**
- * @brief checks the PackageRepository if the members of %groupName differ from %members and replaces with %members if necessary
- * @param groupName (name of the group)
- * @param members (should be output of Package::getPackagesOfGroup)
- */
-void PackageRepository::checkAndSetMembersOfGroup(const QString& groupName, const QStringList& members)
+	return true;
+}
+
+bool PackageRepository::storeSnapshot(const QString& fileName, const qint64 stamp) const
 {
-	std::vector<Group*>::const_iterator groupIt = m_listOfGroups.begin();
-	for (; groupIt != m_listOfGroups.end(); ++groupIt) {
-		if (*groupIt != NULL && (*groupIt)->getName() == groupName) {
-			break;
-		}
+	PackageSnapshot::Writer snapshot(stamp);
+
+	for (TListOfPackages::const_iterator it = m_listOfPackages.begin(); it != m_listOfPackages.end(); ++it) {
+		const PackageData& pkg = **it;
+		PackageSnapshot::PackageRecord record;
+		record.name            = snapshot.addString(pkg.name);
+		record.repository      = snapshot.addString(pkg.repository);
+		record.version         = snapshot.addString(pkg.version);
+		record.description     = snapshot.addString(pkg.description);
+		record.outdatedVersion = snapshot.addString(pkg.outdatedVersion);
+		record.status          = pkg.status;
+		record.flags           = (pkg.required ? PackageSnapshot::eFlagRequired : 0) |
+		                         (pkg.managedByYaourt ? PackageSnapshot::eFlagManagedByYaourt : 0) |
+		                         (pkg.explicitlyInstalled ? PackageSnapshot::eFlagExplicitlyInstalled : 0);
+		record.reserved        = 0;
+		snapshot.addPackage(record, pkg.depends, pkg.provides);
 	}
-	if (groupIt != m_listOfGroups.end()) {
-		Group& group = **groupIt;
-	//    std::cout << "processing group " << group.getName().toStdString() << std::endl;
-		if (group.memberListEquals(members) == false) {
-
-			// invalidate and register all group members if lists are different
-			std::for_each(m_dependingModels.begin(), m_dependingModels.end(), BeginResetModel(eResetGroupMembers));
-			group.invalidateList();
-
-			for (QStringList::const_iterator it = members.begin(); it != members.end(); ++it) {
-				typedef TListOfPackages::const_iterator TIter;
-				std::pair<TIter, TIter> packageIt =  std::equal_range(m_listOfPackages.begin(), m_listOfPackages.end(), *it, TComp());
-				for (TIter iter = packageIt.first; iter != packageIt.second; ++iter) {
-					if ((*iter)->managedByYaourt == false) {
-						group.addPackage(**iter);
-						break;
-					}
-				}
-			}
-			std::for_each(m_dependingModels.begin(), m_dependingModels.end(), EndResetModel(eResetGroupMembers));
-		}
+	foreach (const QString& repository, m_repositoryOrder) {
+		snapshot.addRepository(snapshot.addString(repository));
 	}
-	else {
-		// app did not find package group %name
-		std::cerr << strAppName() << " " << strErrorDnfPackageGroup().toStdString() << " " << groupName.toStdString() << std::endl;
-		assert(false);
+
+	// ids are the indices in the (stored) package list
+	for (std::vector<Group*>::const_iterator it = m_listOfGroups.begin(); it != m_listOfGroups.end(); ++it) {
+		Group& group = **it;
+		const PackageSnapshot::StringRef name = snapshot.addString(group.getName());
+		snapshot.addGroup(name, group.getPackageList());
 	}
+
+	return snapshot.write(fileName);
 }
 
-const PackageRepository::TListOfPackages& PackageRepository::getPackageList() const
+void PackageRepository::setDatabaseState(const PacmanDatabase::Configuration& config, const qint64 stamp)
 {
-	return m_listOfPackages;
+	m_databaseConfig = config;
+	m_databaseStamp  = stamp;
 }
 
-const PackageRepository::TListOfPackages& PackageRepository::getPackageList(const QString& group) const
+const PacmanDatabase::Configuration& PackageRepository::getDatabaseConfiguration() const
 {
-//  std::cout << "get package list for group " << group.toStdString() << std::endl;
-
-	if (!group.isEmpty()) {
-		std::vector<Group*>::const_iterator groupIt = m_listOfGroups.begin();
-		for (; groupIt != m_listOfGroups.end(); ++groupIt) {
-			if (*groupIt != NULL && (*groupIt)->getName() == group) {
-				break;
-			}
-		}
-		if (groupIt != m_listOfGroups.end()) {
-			Group& group = **groupIt;
-			const TListOfPackages* list = group.getPackageList();
-			if (list != NULL) return *list;
-		}
-	}
+	return m_databaseConfig;
+}
 
-	// if no group found or not loaded yet. default to all packages
-	return m_listOfPackages;
+qint64 PackageRepository::getDatabaseStamp() const
+{
+	return m_databaseStamp;
 }
 
 PackageRepository::PackageData* PackageRepository::getFirstPackageByName(const QString name) const
 {
-	for (TListOfPackages::const_iterator it = m_listOfPackages.begin(); it != m_listOfPackages.end(); ++it) {
-		if ((*it)->name == name)
-			return *it;
-	}
-	return NULL;
+	const PackageNameIndex::TIdRange ids = m_store->findByName(name);
+	return ids.first != ids.second ? m_store->package(ids.first) : NULL;
+}
+
+const PackageRepository::Group* PackageRepository::findGroup(const QString& name) const
+{
+	return m_groupsByName.value(name, nullptr);
 }
 
 const std::vector<PackageRepository::Group*>& PackageRepository::getGroupList() const
@@ -273,47 +297,145 @@ const std::vector<PackageRepository::Group*>& PackageRepository::getGroupList()
 	return m_listOfGroups;
 }
 
-const QSet<QString> PackageRepository::getRepos() const
+const PackageStore& PackageRepository::getStore() const
+{
+	return *m_store;
+}
+
+const DependencyGraph& PackageRepository::getDependencyGraph() const
+{
+	return *m_dependencies;
+}
+
+const ProvidesIndex& PackageRepository::getProvidesIndex() const
 {
-	return m_setOfRepos;
+	return *m_provides;
+}
+
+const TrigramIndex& PackageRepository::getDescriptionIndex() const
+{
+	return *m_descriptions;
+}
+
+PackageRepository::PackageArenaStatistics PackageRepository::getArenaStatistics() const
+{
+	const PackageArena::Statistics& sync    = m_syncArena->getStatistics();
+	const PackageArena::Statistics& foreign = m_foreignArena->getStatistics();
+
+	PackageArenaStatistics result;
+	result.generations   = m_retiredGenerations;
+	result.blocks        = sync.blocks + foreign.blocks;
+	result.bytesReserved = sync.reserved + foreign.reserved;
+	result.bytesUsed     = sync.used + foreign.used;
+	result.allocations   = sync.allocations + foreign.allocations;
+	return result;
 }
 
 std::size_t PackageRepository::countTotal() const
 {
-	return getPackageList().size();
+	return m_store->size();
 }
 
 std::size_t PackageRepository::countInstalled() const
 {
-	return std::count_if(m_listOfPackages.cbegin(), m_listOfPackages.cend(), [](const TListOfPackages::value_type& t){
-		return t->installed();
+	const PackageStore& store = *m_store;
+	return std::count_if(store.getIds().cbegin(), store.getIds().cend(), [&](const quint32 id){
+		return store.installed(id);
 	});
 }
 
 std::size_t PackageRepository::countOutdated(const bool noForeign) const
 {
-	return std::count_if(m_listOfPackages.cbegin(), m_listOfPackages.cend(), [=](const TListOfPackages::value_type& t){
-		return t->outdated() && (!noForeign || t->managedByYaourt == false);
+	const PackageStore& store = *m_store;
+	return std::count_if(store.getIds().cbegin(), store.getIds().cend(), [&](const quint32 id){
+		const PackageStatus status = store.status(id);
+		return (status == epkg_OUTDATED || status == epkg_NEWER || status == epkg_FOREIGN_OUTDATED) &&
+		       (!noForeign || store.hasFlag(id, PackageStore::eFlagManagedByYaourt) == false);
 	});
 }
 
 /**
- * @brief checks if the repository groups are up to date
- * @param listOfGroups == group-names
- * @return true if the groups in this repository are the same as the %listOfGroups
+ * @brief assigns the ids (index in the sorted list) and rebuilds the columns and all indices of them
  */
-bool PackageRepository::memberListOfGroupsEquals(const QStringList& listOfGroups)
+void PackageRepository::rebuildStore()
 {
-	if (m_listOfGroups.size() != static_cast<std::size_t>(listOfGroups.size()))
-		return false;
+	for (std::size_t x = 0; x < m_listOfPackages.size(); ++x) {
+		PackageGuard::setId(*m_listOfPackages[x], x);
+	}
+	m_store->reset(m_listOfPackages, m_repositoryOrder);
+	m_provides->reset(*m_store);
+	m_dependencies->reset(*m_store, *m_provides);
+
+	// lower case, the search is case insensitive beyond ASCII
+	m_descriptions->clear();
+	for (std::size_t x = 0; x < m_listOfPackages.size(); ++x) {
+		const QByteArray description = m_listOfPackages[x]->description.toLower().toUtf8();
+		m_descriptions->add(x, description.constData(), description.size());
+	}
+	m_descriptions->finish();
+}
+
+/**
+ * @brief destroys all packages allocated from %arena and releases its memory in one shot
+ * @param managedByYaourt (true for the foreign arena)
+ */
+void PackageRepository::retireGeneration(PackageArena& arena, const bool managedByYaourt)
+{
+	TListOfPackages::iterator end = std::remove_if(m_listOfPackages.begin(), m_listOfPackages.end(),
+	                                               [=](PackageData* pkg) {
+		if (pkg->managedByYaourt != managedByYaourt) return false;
+		pkg->~PackageData();
+		return true;
+	});
+	m_listOfPackages.erase(end, m_listOfPackages.end());
+	arena.release();
+	++m_retiredGenerations;
+}
 
-	QStringList::const_iterator it2 = listOfGroups.begin();
-	for (std::vector<Group*>::const_iterator it = m_listOfGroups.begin(); it != m_listOfGroups.end(); ++it, ++it2) {
-		if ((*it)->getName() != *it2)
-			return false;
+void PackageRepository::retireAllGenerations()
+{
+	for (TListOfPackages::const_iterator it = m_listOfPackages.begin(); it != m_listOfPackages.end(); ++it) {
+		if (*it != nullptr) (*it)->~PackageData();
 	}
+	m_listOfPackages.clear();
+	m_syncArena->release();
+	m_foreignArena->release();
+	m_retiredGenerations += 2;
+}
 
-	return true;
+/**
+ * @brief replaces all groups, must be called after rebuildStore
+ * @param members (group name -> packages of the current generation)
+ */
+void PackageRepository::rebuildGroups(const QMap<QString, TListOfPackages>& members)
+{
+	deleteGroups();
+	for (QMap<QString, TListOfPackages>::const_iterator it = members.begin(); it != members.end(); ++it) {
+		TListOfIds ids;
+		ids.reserve(it->size());
+		for (TListOfPackages::const_iterator pkg = it->begin(); pkg != it->end(); ++pkg) {
+			ids.push_back((*pkg)->getId());
+		}
+		addGroup(new Group(it.key(), std::move(ids), m_store->size()));
+	}
+}
+
+/**
+ * @brief takes ownership of %group, groups must be added in order of their names
+ */
+void PackageRepository::addGroup(Group*const group)
+{
+	m_listOfGroups.push_back(group);
+	m_groupsByName.insert(group->getName(), group);
+}
+
+void PackageRepository::deleteGroups()
+{
+	for (std::vector<Group*>::const_iterator it = m_listOfGroups.begin(); it != m_listOfGroups.end(); ++it) {
+		if (*it != nullptr) delete *it;
+	}
+	m_listOfGroups.clear();
+	m_groupsByName.clear();
 }
 
 //////// PackageRepository::PackageData //////////////////////////////
@@ -327,61 +449,37 @@ PackageRepository::PackageData::PackageData(const PackageListData& pkg, const bo
 	  explicitlyInstalled(wasExplicitlyInstalled), name(pkg.name),
 	  repository(pkg.repository),
 	  version(pkg.version), description(pkg.description), outdatedVersion(pkg.outatedVersion),
+	  depends(pkg.depends), provides(pkg.provides),
 	  status(pkg.status != epkg_OUTDATED ?
 	    pkg.status :
-	      (Pacman::rpmvercmp(pkg.outatedVersion.toLatin1().data(), pkg.version.toLatin1().data()) == 1 ?
-	        epkg_NEWER : epkg_OUTDATED))
+	      (Pacman::vercmp(pkg.outatedVersion, pkg.version) == 1 ? epkg_NEWER : epkg_OUTDATED)),
+	  storeId(0)
 {
 }
 
 //////// PackageRepository::Group //////////////////////////////
-std::unique_ptr<PackageRepository::TListOfPackages>
-		PackageRepository::Group::NO_PACKAGES(new PackageRepository::TListOfPackages());
-
-PackageRepository::Group::Group(const QString& grpName)
-	: name(grpName), m_listOfPackages(NO_PACKAGES.get())
+PackageRepository::Group::Group(const QString& grpName, TListOfIds&& ids, const quint32 packageCount)
+	: name(grpName), m_listOfPackages(std::move(ids))
 {
+	std::sort(m_listOfPackages.begin(), m_listOfPackages.end());
+	m_members = PackageBitset(packageCount, m_listOfPackages);
 }
 
-const QString& PackageRepository::Group::getName()
+const QString& PackageRepository::Group::getName() const
 {
 	return name;
 }
 
-bool PackageRepository::Group::memberListEquals(const QStringList& packagelist)
+const PackageRepository::TListOfIds& PackageRepository::Group::getPackageList() const
 {
-	if (m_listOfPackages == NO_PACKAGES.get() || m_listOfPackages->size() != static_cast<std::size_t>(packagelist.size()))
-		return false;
-
-	QStringList::const_iterator it2 = packagelist.begin();
-	for (TListOfPackages::const_iterator it = m_listOfPackages->begin(); it != m_listOfPackages->end(); ++it, ++it2) {
-		if ((*it)->name != *it2)
-			return false;
-	}
-
-	return true;
-}
-
-void PackageRepository::Group::addPackage(PackageRepository::PackageData& package)
-{
-	if (m_listOfPackages == NO_PACKAGES.get())
-		m_listOfPackages = new TListOfPackages();
-
-	m_listOfPackages->push_back(&package);
-}
-
-void PackageRepository::Group::invalidateList()
-{
-//  std::cout << "invalidate group " << name.toStdString() << std::endl;
-
-	if (m_listOfPackages == NO_PACKAGES.get())
-		return;
-
-	delete m_listOfPackages;
-	m_listOfPackages = NO_PACKAGES.get();
+	return m_listOfPackages;
 }
 
-const PackageRepository::TListOfPackages* PackageRepository::Group::getPackageList() const
+void PackageRepository::Group::remapPackages(const TListOfIds& newIds, const quint32 packageCount)
 {
-	return m_listOfPackages;
+	for (TListOfIds::iterator it = m_listOfPackages.begin(); it != m_listOfPackages.end(); ++it) {
+		*it = newIds[*it];
+	}
+	std::sort(m_listOfPackages.begin(), m_listOfPackages.end());
+	m_members = PackageBitset(packageCount, m_listOfPackages);
 }
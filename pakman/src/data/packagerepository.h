@@ -24,9 +24,19 @@
 #include <vector>
 #include <memory>
 #include <cassert>
+#include <QHash>
+#include <QMap>
 #include <QSet>
 
 #include "src/commands/pacman.h"
+#include "src/commands/pacmandatabase.h"
+#include "src/data/packagebitset.h"
+
+class DependencyGraph;
+class PackageArena;
+class PackageStore;
+class ProvidesIndex;
+class TrigramIndex;
 
 
 /**
@@ -37,12 +47,19 @@ class PackageRepository
 public:
 	class PackageData;
 	typedef std::vector<PackageData*> TListOfPackages;
+	typedef std::vector<quint32>      TListOfIds;      // see PackageStore
+
+	struct PackageArenaStatistics {
+		std::size_t generations; // number of generations retired so far
+		std::size_t blocks;
+		std::size_t bytesReserved;
+		std::size_t bytesUsed;
+		std::size_t allocations;
+	};
 
 public:
 	enum EResetType {
-		eResetRepository,  // All Package ptr have been reset (basically a full reset)
-		eResetGroupList,   // The list of package groups has been reset (including members)
-		eResetGroupMembers // The members of existing groups (packages) have changed
+		eResetRepository // All Package ptr and groups have been reset (basically a full reset)
 	};
 
 	////////////////////////
@@ -65,7 +82,6 @@ public:
 	class PackageData {
 	public:
 		friend class PackageRepository::PackageGuard;
-		typedef TListOfPackages TDependencyVec;
 
 	public:
 		/**
@@ -83,25 +99,16 @@ public:
 			return status == epkg_OUTDATED || status == epkg_NEWER || status == epkg_FOREIGN_OUTDATED;
 		}
 
-		inline const TDependencyVec* getDependsOn() const {
-			return dependsOn.get();
-		}
-
-		inline const TDependencyVec* getRequiredBy() const {
-			return requiredBy.get();
+		/**
+		 * @brief id in the PackageStore of the repository
+		 */
+		inline quint32 getId() const {
+			return storeId;
 		}
 
 		private:
-		inline void setDependsOn(const TDependencyVec* packages) {
-	//      std::cout << "set dependencies for " << name.toStdString() << " to " << dependencies << std::endl;
-			this->dependsOn.reset(packages);
-		}
-		inline void resetRequiredBy() {
-			this->requiredBy.reset(new TDependencyVec());
-		}
-		inline void addRequiredBy(PackageData& pkg) {
-			assert(this->requiredBy.get() != NULL);
-			this->requiredBy->push_back(&pkg);
+		inline void setId(const quint32 id) {
+			this->storeId = id;
 		}
 
 		public:
@@ -113,14 +120,15 @@ public:
 		const QString version;
 		const QString description;
 		const QString outdatedVersion;
+		const QStringList depends;  // see PackageListData, resolved by the DependencyGraph
+		const QStringList provides;
 	//	const double  downloadSize;
 		const PackageStatus status;
 	//	const int     popularity; // -1 for non AUR
 	//	const QString popularityString;
 
 		private:
-		std::auto_ptr<const TDependencyVec> dependsOn;
-		std::auto_ptr<TDependencyVec>       requiredBy;
+		quint32 storeId;
 	};
 
 	////////////////////////
@@ -130,9 +138,7 @@ public:
 	class PackageGuard {
 		friend class PackageRepository;
 
-		inline static void setDependencies(PackageData& pkg, const PackageData::TDependencyVec*const dependencies);
-		inline static void resetRequirements(PackageData& pkg);
-		inline static void addRequirement(PackageData& pkg, PackageData& dependsOnPkg);
+		inline static void setId(PackageData& pkg, const quint32 id);
 	};
 
 	////////////////////////
@@ -141,20 +147,27 @@ public:
 	 */
 	class Group {
 	public:
-		Group(const QString& name);
+		/**
+		 * @param ids (member ids, will be sorted)
+		 * @param packageCount (number of packages in the store, size of the member bitset)
+		 */
+		Group(const QString& name, TListOfIds&& ids, const quint32 packageCount);
 
-		const QString& getName();
-		bool memberListEquals(const QStringList& packagelist);
-		void addPackage(PackageData& package);
-		void invalidateList();
+		const QString& getName() const;
 
-		const TListOfPackages* getPackageList() const;
+		const TListOfIds& getPackageList() const;
+		inline const PackageBitset& getMembers() const {
+			return m_members;
+		}
+		/**
+		 * @brief replaces every member id by %newIds[id]
+		 */
+		void remapPackages(const TListOfIds& newIds, const quint32 packageCount);
 
 	private:
-		QString name;
-		TListOfPackages* m_listOfPackages; // STRONG ptr list, WEAK ptr PackageData*
-	private:
-		static std::unique_ptr<TListOfPackages> NO_PACKAGES;
+		QString       name;
+		TListOfIds    m_listOfPackages; // sorted package ids
+		PackageBitset m_members;        // same as m_listOfPackages
 	};
 	////////////////////////
 
@@ -164,41 +177,92 @@ public:
 
 	void registerDependency(IDependency& depends);
 	void deregisterDependency(IDependency& depends);
-	void setData(const QList<PackageListData>*const listOfPackages, const QSet<QString>& unrequiredPackages,
-	             const QSet<QString>& explicitlyInstalledPackages);
-	void setAURData(/*inout*/QList<PackageListData>*const listOfForeignPackages, const QSet<QString>& unrequiredPackages,
+	void setData(const QList<PackageListData>*const listOfPackages, const TLocalPackages& localPackages);
+	void setAURData(/*inout*/QList<PackageListData>*const listOfForeignPackages, const TLocalPackages& localPackages,
 	                const QMap<QString, PackageListData>*const aurPackageData);
-	void checkAndSetGroups(const QStringList& listOfGroups);
-	void checkAndSetMembersOfGroup(const QString& group, const QStringList& members);
+	/**
+	 * @brief replaces packages and groups with the content of a snapshot file
+	 * @param stamp (modification stamp of the pacman databases, see PacmanDatabase::getModificationStamp)
+	 * @return false (and nothing changed) if there is no snapshot for %stamp
+	 */
+	bool restoreSnapshot(const QString& fileName, const qint64 stamp);
+	/**
+	 * @brief writes packages and groups into a snapshot file, see packagesnapshot.h
+	 * @param stamp (modification stamp of the pacman databases the packages were read from)
+	 */
+	bool storeSnapshot(const QString& fileName, const qint64 stamp) const;
+	/**
+	 * @brief pacman configuration and database modification stamp the current packages were read with
+	 * @param stamp (see PacmanDatabase::getModificationStamp)
+	 *
+	 * set after every refresh (or restore), the getters must only be used between two tasks or in a task
+	 */
+	void setDatabaseState(const PacmanDatabase::Configuration& config, const qint64 stamp);
+	const PacmanDatabase::Configuration& getDatabaseConfiguration() const;
+	/**
+	 * @return 0 if no packages were read yet
+	 */
+	qint64 getDatabaseStamp() const;
 
-	const TListOfPackages& getPackageList() const;
-	const TListOfPackages& getPackageList(const QString& group) const;
 	PackageData*           getFirstPackageByName(const QString name) const;
+	/**
+	 * @return nullptr if there is no group called %name
+	 */
+	const Group*           findGroup(const QString& name) const;
+	/**
+	 * @brief columnar view of all packages, rebuilt on every eResetRepository
+	 */
+	const PackageStore&    getStore() const;
+	/**
+	 * @brief dependencies between the packages of getStore(), rebuilt on every eResetRepository
+	 */
+	const DependencyGraph& getDependencyGraph() const;
+	/**
+	 * @brief providers of virtual packages in getStore(), rebuilt on every eResetRepository
+	 */
+	const ProvidesIndex&   getProvidesIndex() const;
+	/**
+	 * @brief trigrams of the lower case descriptions (including the name) by id of getStore(), rebuilt on every eResetRepository
+	 */
+	const TrigramIndex&    getDescriptionIndex() const;
 
 	const std::vector<Group*>& getGroupList() const;
-	const QSet<QString>    getRepos() const;
+
+	/**
+	 * @brief memory statistics of the package generations (sync + foreign), shown after every eResetRepository
+	 */
+	PackageArenaStatistics getArenaStatistics() const;
 
 	std::size_t countTotal() const;
 	std::size_t countInstalled() const;
 	std::size_t countOutdated(const bool noForeign) const;
 
 private:
-	std::vector<IDependency*> m_dependingModels;
-	QSet<QString>             m_setOfRepos;           // Set of all available Repositories
-	TListOfPackages           m_listOfPackages;       // sorted qlist of all packages
-	std::vector<Group*>       m_listOfGroups;         // sorted list of all pacman package groups
-	bool memberListOfGroupsEquals(const QStringList& listOfGroups);
+	std::vector<IDependency*>     m_dependingModels;
+	TListOfPackages               m_listOfPackages;       // sorted qlist of all packages
+	std::unique_ptr<PackageStore> m_store;                // columns of m_listOfPackages
+	std::unique_ptr<ProvidesIndex> m_provides;            // of m_store
+	std::unique_ptr<DependencyGraph> m_dependencies;      // of m_store
+	std::unique_ptr<TrigramIndex> m_descriptions;         // of m_store
+	QStringList                   m_repositoryOrder;      // sync repositories in order of pacman.conf
+	std::unique_ptr<PackageArena> m_syncArena;            // memory of all packages created by setData
+	std::unique_ptr<PackageArena> m_foreignArena;         // memory of all packages created by setAURData
+	std::size_t                   m_retiredGenerations;
+	std::vector<Group*>           m_listOfGroups;         // sorted list of all pacman package groups
+	QHash<QString, Group*>        m_groupsByName;         // WEAK, same as m_listOfGroups
+	PacmanDatabase::Configuration m_databaseConfig;       // pacman.conf at the time of the last refresh
+	qint64                        m_databaseStamp;        // modification stamp of the databases of m_listOfPackages
+	void rebuildStore();
+	void rebuildGroups(const QMap<QString, TListOfPackages>& members);
+	void addGroup(Group*const group);
+	void deleteGroups();
+	void retireGeneration(PackageArena& arena, const bool managedByYaourt);
+	void retireAllGenerations();
 };
 
 
-void PackageRepository::PackageGuard::setDependencies(PackageData& pkg, const PackageData::TDependencyVec*const dependencies) {
-	pkg.setDependsOn(dependencies);
-}
-void PackageRepository::PackageGuard::resetRequirements(PackageData& pkg) {
-	pkg.resetRequiredBy();
-}
-void PackageRepository::PackageGuard::addRequirement(PackageData& pkg, PackageData& dependsOnPkg) {
-	pkg.addRequiredBy(dependsOnPkg);
+void PackageRepository::PackageGuard::setId(PackageData& pkg, const quint32 id) {
+	pkg.setId(id);
 }
 
 #endif // PACMANQT_PACKAGEREPOSITORY_H
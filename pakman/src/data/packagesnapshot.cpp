@@ -0,0 +1,232 @@
+/*
+* This file is part of pakman, an open-source GUI for pacman.
+* Copyright (C) 2014 Thomas Binkau
+*
+* This program is free software; you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation; either version 2 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+*
+*/
+
+#include "packagesnapshot.h"
+
+#include <cstring>
+
+#include "src/data/packagedata.h"
+
+
+namespace PackageSnapshot {
+
+namespace {
+
+const char    MAGIC[8]        = { 'P', 'A', 'K', 'M', 'A', 'N', 'S', 'S' };
+const quint32 BYTE_ORDER_MARK = 0x01020304;
+
+bool writeAll(QFile& file, const void* data, const qint64 size)
+{
+	return size == 0 || file.write(static_cast<const char*>(data), size) == size;
+}
+
+}
+
+//////// PackageSnapshot::Writer //////////////////////////////
+
+Writer::Writer(const qint64 stamp)
+	: m_stamp(stamp)
+{
+}
+
+StringRef Writer::addString(const QString& str)
+{
+	QHash<QString, StringRef>::const_iterator it = m_strings.find(str);
+	if (it != m_strings.end())
+		return *it;
+
+	StringRef ref;
+	ref.offset = m_pool.size();
+	ref.length = str.size();
+	m_pool += str;
+	m_strings.insert(str, ref);
+	return ref;
+}
+
+void Writer::addPackage(PackageRecord& package, const QStringList& depends, const QStringList& provides)
+{
+	package.firstRelation = m_relations.size();
+	package.dependsCount  = depends.size();
+	package.providesCount = provides.size();
+	foreach (const QString& relation, depends) {
+		m_relations.push_back(addString(relation));
+	}
+	foreach (const QString& relation, provides) {
+		m_relations.push_back(addString(relation));
+	}
+	m_packages.push_back(package);
+}
+
+void Writer::addGroup(const StringRef& name, const std::vector<quint32>& members)
+{
+	GroupRecord group;
+	group.name        = name;
+	group.firstMember = m_members.size();
+	group.memberCount = members.size();
+	m_members.insert(m_members.end(), members.begin(), members.end());
+	m_groups.push_back(group);
+}
+
+void Writer::addRepository(const StringRef& name)
+{
+	m_repositories.push_back(name);
+}
+
+bool Writer::write(const QString& fileName) const
+{
+	Header header;
+	memcpy(header.magic, MAGIC, sizeof(MAGIC));
+	header.version         = FORMAT_VERSION;
+	header.byteOrder       = BYTE_ORDER_MARK;
+	header.stamp           = m_stamp;
+	header.packageCount    = m_packages.size();
+	header.groupCount      = m_groups.size();
+	header.memberCount     = m_members.size();
+	header.relationCount   = m_relations.size();
+	header.repositoryCount = m_repositories.size();
+	header.poolSize        = m_pool.size();
+
+	// write to a temporary file first, a mapped old snapshot must not change
+	const QString tmpFileName = fileName + ".tmp";
+	QFile file(tmpFileName);
+	if (file.open(QIODevice::WriteOnly | QIODevice::Truncate) == false)
+		return false;
+
+	const bool ok = writeAll(file, &header, sizeof(header)) &&
+	                writeAll(file, m_packages.data(), m_packages.size() * sizeof(PackageRecord)) &&
+	                writeAll(file, m_groups.data(), m_groups.size() * sizeof(GroupRecord)) &&
+	                writeAll(file, m_members.data(), m_members.size() * sizeof(quint32)) &&
+	                writeAll(file, m_relations.data(), m_relations.size() * sizeof(StringRef)) &&
+	                writeAll(file, m_repositories.data(), m_repositories.size() * sizeof(StringRef)) &&
+	                writeAll(file, m_pool.constData(), m_pool.size() * sizeof(QChar));
+	file.close();
+
+	if (ok == false || file.error() != QFile::NoError) {
+		QFile::remove(tmpFileName);
+		return false;
+	}
+	QFile::remove(fileName);
+	return QFile::rename(tmpFileName, fileName);
+}
+
+//////// PackageSnapshot::Reader //////////////////////////////
+
+Reader::Reader(const QString& fileName)
+	: m_file(fileName), m_header(nullptr), m_packages(nullptr), m_groups(nullptr), m_members(nullptr),
+	  m_relations(nullptr), m_repositories(nullptr), m_pool(nullptr)
+{
+}
+
+bool Reader::open(const qint64 stamp)
+{
+	if (m_file.open(QIODevice::ReadOnly) == false || m_file.size() < static_cast<qint64>(sizeof(Header)))
+		return false;
+
+	const uchar*const data = m_file.map(0, m_file.size());
+	if (data == nullptr)
+		return false;
+
+	const Header*const header = reinterpret_cast<const Header*>(data);
+	if (memcmp(header->magic, MAGIC, sizeof(MAGIC)) != 0 || header->version != FORMAT_VERSION ||
+	    header->byteOrder != BYTE_ORDER_MARK || header->stamp != stamp)
+		return false;
+
+	const quint64 packagesOffset     = sizeof(Header);
+	const quint64 groupsOffset       = packagesOffset + quint64(header->packageCount) * sizeof(PackageRecord);
+	const quint64 membersOffset      = groupsOffset + quint64(header->groupCount) * sizeof(GroupRecord);
+	const quint64 relationsOffset    = membersOffset + quint64(header->memberCount) * sizeof(quint32);
+	const quint64 repositoriesOffset = relationsOffset + quint64(header->relationCount) * sizeof(StringRef);
+	const quint64 poolOffset         = repositoriesOffset + quint64(header->repositoryCount) * sizeof(StringRef);
+	const quint64 size               = poolOffset + quint64(header->poolSize) * sizeof(QChar);
+	if (size != static_cast<quint64>(m_file.size()))
+		return false;
+
+	m_header       = header;
+	m_packages     = reinterpret_cast<const PackageRecord*>(data + packagesOffset);
+	m_groups       = reinterpret_cast<const GroupRecord*>(data + groupsOffset);
+	m_members      = reinterpret_cast<const quint32*>(data + membersOffset);
+	m_relations    = reinterpret_cast<const StringRef*>(data + relationsOffset);
+	m_repositories = reinterpret_cast<const StringRef*>(data + repositoriesOffset);
+	m_pool         = reinterpret_cast<const QChar*>(data + poolOffset);
+
+	// validate all references once, the accessors do not check anything
+	for (quint32 x = 0; x < header->packageCount; ++x) {
+		const PackageRecord& pkg = m_packages[x];
+		if (isValid(pkg.name) == false || isValid(pkg.repository) == false || isValid(pkg.version) == false ||
+		    isValid(pkg.description) == false || isValid(pkg.outdatedVersion) == false ||
+		    pkg.status > epkg_FOREIGN_OUTDATED ||
+		    quint64(pkg.firstRelation) + pkg.dependsCount + pkg.providesCount > header->relationCount)
+			return false;
+	}
+	for (quint32 x = 0; x < header->relationCount; ++x) {
+		if (isValid(m_relations[x]) == false)
+			return false;
+	}
+	for (quint32 x = 0; x < header->repositoryCount; ++x) {
+		if (isValid(m_repositories[x]) == false)
+			return false;
+	}
+	for (quint32 x = 0; x < header->groupCount; ++x) {
+		const GroupRecord& group = m_groups[x];
+		if (isValid(group.name) == false)
+			return false;
+		if (quint64(group.firstMember) + group.memberCount > header->memberCount)
+			return false;
+		for (quint32 y = 0; y < group.memberCount; ++y) {
+			if (m_members[group.firstMember + y] >= header->packageCount)
+				return false;
+		}
+	}
+	return true;
+}
+
+QStringList Reader::depends(const PackageRecord& package) const
+{
+	QStringList result;
+	for (quint32 x = 0; x < package.dependsCount; ++x) {
+		result << string(m_relations[package.firstRelation + x]);
+	}
+	return result;
+}
+
+QStringList Reader::provides(const PackageRecord& package) const
+{
+	QStringList result;
+	for (quint32 x = 0; x < package.providesCount; ++x) {
+		result << string(m_relations[package.firstRelation + package.dependsCount + x]);
+	}
+	return result;
+}
+
+QStringList Reader::repositories() const
+{
+	QStringList result;
+	for (quint32 x = 0; x < m_header->repositoryCount; ++x) {
+		result << string(m_repositories[x]);
+	}
+	return result;
+}
+
+bool Reader::isValid(const StringRef& ref) const
+{
+	return quint64(ref.offset) + ref.length <= m_header->poolSize;
+}
+
+}
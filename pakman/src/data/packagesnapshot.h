@@ -0,0 +1,182 @@
+/*
+* This file is part of pakman, an open-source GUI for pacman.
+* Copyright (C) 2014 Thomas Binkau
+*
+* This program is free software; you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation; either version 2 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+*
+*/
+
+#ifndef PACKAGESNAPSHOT_H
+#define PACKAGESNAPSHOT_H
+
+#include <vector>
+#include <QFile>
+#include <QHash>
+#include <QString>
+#include <QStringList>
+
+
+/**
+ * @brief binary snapshot of the PackageRepository, used for a fast startup
+ *
+ * The file is written in host byte order and mapped into memory for reading:
+ *
+ * Header | PackageRecord[packageCount] | GroupRecord[groupCount] | quint32 member[memberCount] |
+ * StringRef relation[relationCount] | StringRef repository[repositoryCount] | QChar pool[poolSize]
+ *
+ * All strings are stored as utf16 in the pool, every record refers to them by offset and length.
+ */
+namespace PackageSnapshot
+{
+	/**
+	 * @brief must be increased on every change of the file layout
+	 */
+	const quint32 FORMAT_VERSION = 4;
+
+	struct StringRef {
+		quint32 offset; // in QChars
+		quint32 length; // in QChars
+	};
+
+	struct Header {
+		char    magic[8];
+		quint32 version;      // FORMAT_VERSION
+		quint32 byteOrder;    // BYTE_ORDER_MARK in host byte order
+		qint64  stamp;        // modification stamp of the pacman databases
+		quint32 packageCount;
+		quint32 groupCount;
+		quint32 memberCount;
+		quint32 relationCount;
+		quint32 repositoryCount; // in order of priority
+		quint32 poolSize;     // in QChars
+	};
+
+	struct PackageRecord {
+		StringRef name;
+		StringRef repository;
+		StringRef version;
+		StringRef description;
+		StringRef outdatedVersion;
+		quint8    status;     // PackageStatus
+		quint8    flags;      // EPackageFlags
+		quint16   reserved;
+		quint32   firstRelation; // depends followed by provides
+		quint32   dependsCount;
+		quint32   providesCount;
+	};
+
+	enum EPackageFlags {
+		eFlagRequired            = 0x01,
+		eFlagManagedByYaourt     = 0x02,
+		eFlagExplicitlyInstalled = 0x04
+	};
+
+	struct GroupRecord {
+		StringRef name;
+		quint32   firstMember;
+		quint32   memberCount;
+	};
+
+	////////////////////////
+	/**
+	 * @brief collects the records in memory, the strings are deduplicated
+	 */
+	class Writer {
+	public:
+		explicit Writer(const qint64 stamp);
+
+		StringRef addString(const QString& str);
+		/**
+		 * @brief relations of %package will be set by this function
+		 */
+		void addPackage(PackageRecord& package, const QStringList& depends, const QStringList& provides);
+		/**
+		 * @param members (index of each member in the package list)
+		 */
+		void addGroup(const StringRef& name, const std::vector<quint32>& members);
+		/**
+		 * @brief repositories must be added in order of their priority
+		 */
+		void addRepository(const StringRef& name);
+
+		/**
+		 * @brief replaces %fileName, the old snapshot stays valid for running readers
+		 */
+		bool write(const QString& fileName) const;
+
+	private:
+		qint64                      m_stamp;
+		std::vector<PackageRecord>  m_packages;
+		std::vector<GroupRecord>    m_groups;
+		std::vector<quint32>        m_members;
+		std::vector<StringRef>      m_relations;
+		std::vector<StringRef>      m_repositories;
+		QString                     m_pool;
+		QHash<QString, StringRef>   m_strings;
+	};
+
+	////////////////////////
+	/**
+	 * @brief read only view of a mapped snapshot, all records are validated on open
+	 */
+	class Reader {
+	public:
+		explicit Reader(const QString& fileName);
+
+		/**
+		 * @brief false if the file is missing, broken, of another version or not taken at %stamp
+		 */
+		bool open(const qint64 stamp);
+
+		inline quint32 packageCount() const {
+			return m_header->packageCount;
+		}
+		inline const PackageRecord& package(const quint32 index) const {
+			return m_packages[index];
+		}
+		inline quint32 groupCount() const {
+			return m_header->groupCount;
+		}
+		inline const GroupRecord& group(const quint32 index) const {
+			return m_groups[index];
+		}
+		inline const quint32* members(const GroupRecord& group) const {
+			return m_members + group.firstMember;
+		}
+		inline QString string(const StringRef& ref) const {
+			return QString(m_pool + ref.offset, ref.length);
+		}
+		QStringList depends(const PackageRecord& package) const;
+		QStringList provides(const PackageRecord& package) const;
+		/**
+		 * @brief names of all repositories in order of their priority
+		 */
+		QStringList repositories() const;
+
+	private:
+		bool isValid(const StringRef& ref) const;
+
+		QFile                m_file;
+		const Header*        m_header;
+		const PackageRecord* m_packages;
+		const GroupRecord*   m_groups;
+		const quint32*       m_members;
+		const StringRef*     m_relations;
+		const StringRef*     m_repositories;
+		const QChar*         m_pool;
+	};
+};
+
+#endif // PACKAGESNAPSHOT_H
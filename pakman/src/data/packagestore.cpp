@@ -0,0 +1,107 @@
+/*
+* This file is part of pakman, an open-source GUI for pacman.
+* Copyright (C) 2014 Thomas Binkau
+*
+* This program is free software; you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation; either version 2 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+*
+*/
+
+#include "packagestore.h"
+
+#include <QSet>
+
+#include "src/commands/pacman.h"
+
+
+PackageStore::PackageStore()
+	: m_generation(0), m_packages(nullptr)
+{
+	m_nameOffset.push_back(0);
+	m_versionKeyOffset.push_back(0);
+}
+
+void PackageStore::reset(const PackageRepository::TListOfPackages& packages, const QStringList& repositoryOrder)
+{
+	const std::size_t count = packages.size();
+	++m_generation;
+	m_packages = &packages;
+
+	// repositories (ids in order of their names)
+	QSet<QString> repositories;
+	for (PackageRepository::TListOfPackages::const_iterator it = packages.begin(); it != packages.end(); ++it) {
+		repositories << (*it)->repository;
+	}
+	m_repositories = repositories.toList();
+	qSort(m_repositories);
+	m_repositoryIds.clear();
+	m_repositoryPriority.resize(m_repositories.size());
+	for (int x = 0; x < m_repositories.size(); ++x) {
+		m_repositoryIds.insert(m_repositories[x], x);
+		const int priority = repositoryOrder.indexOf(m_repositories[x]);
+		m_repositoryPriority[x] = priority != -1 ? priority : repositoryOrder.size();
+	}
+
+	// columns
+	m_ids.resize(count);
+	m_status.resize(count);
+	m_flags.resize(count);
+	m_facets.resize(count);
+	m_repositoryId.resize(count);
+	m_nameOffset.resize(count + 1);
+	m_versionKeyOffset.resize(count + 1);
+	m_namePool.clear();
+	m_versionKeys.clear();
+
+	m_nameOffset[0] = 0;
+	m_versionKeyOffset[0] = 0;
+	for (std::size_t x = 0; x < count; ++x) {
+		const PackageRepository::PackageData& pkg = *packages[x];
+		m_ids[x]          = x;
+		m_status[x]       = pkg.status;
+		m_flags[x]        = (pkg.required ? eFlagRequired : 0) |
+		                    (pkg.managedByYaourt ? eFlagManagedByYaourt : 0) |
+		                    (pkg.explicitlyInstalled ? eFlagExplicitlyInstalled : 0);
+		m_repositoryId[x] = m_repositoryIds.value(pkg.repository);
+		// the combinations the filters care about are precomputed, only installed packages are implicit or required
+		const bool installed = pkg.status != epkg_NON_INSTALLED;
+		m_facets[x]       = statusFacet(pkg.status) |
+		                    (pkg.explicitlyInstalled ? eFacetExplicit : (installed ? eFacetImplicitInstalled : 0)) |
+		                    (pkg.required ? (installed ? eFacetRequiredInstalled : 0) : eFacetNotRequired) |
+		                    (pkg.status == epkg_FOREIGN || pkg.status == epkg_FOREIGN_OUTDATED ? eFacetForeign : 0);
+
+		m_namePool += pkg.name;
+		m_nameOffset[x + 1] = m_namePool.size();
+		m_versionKeys += Pacman::versionKey(pkg.version);
+		m_versionKeyOffset[x + 1] = m_versionKeys.size();
+	}
+	m_namePool.squeeze();
+	m_versionKeys.squeeze();
+	m_nameIndex.reset(*this);
+}
+
+int PackageStore::findRepositoryId(const QString& repository) const
+{
+	return m_repositoryIds.value(repository, -1);
+}
+
+quint64 PackageStore::repositoryMask(const QSet<QString>& repositories) const
+{
+	quint64 mask = 0;
+	foreach (const QString& repository, repositories) {
+		const int id = findRepositoryId(repository);
+		if (id != -1) mask |= quint64(1) << std::min(id, 63);
+	}
+	return mask;
+}
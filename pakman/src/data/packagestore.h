@@ -0,0 +1,209 @@
+/*
+* This file is part of pakman, an open-source GUI for pacman.
+* Copyright (C) 2014 Thomas Binkau
+*
+* This program is free software; you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation; either version 2 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+*
+*/
+
+#ifndef PACKAGESTORE_H
+#define PACKAGESTORE_H
+
+#include <algorithm>
+#include <cstring>
+#include <vector>
+#include <QByteArray>
+#include <QHash>
+#include <QSet>
+#include <QString>
+#include <QStringList>
+
+#include "src/data/packagenameindex.h"
+#include "src/data/packagerepository.h"
+
+
+/**
+ * @brief Columnar view of all packages of the PackageRepository
+ *
+ * A package is addressed by its id, which is its position in the (name sorted) package list.
+ * Ids are stable until the next reset of the repository. The columns hold everything
+ * needed for filtering and sorting, so these do not need to touch PackageData at all.
+ */
+class PackageStore
+{
+public:
+	typedef PackageRepository::TListOfIds TIdList;
+
+	static const int ctn_MAX_MASKED_REPOSITORIES = 64; // see repositoryBit
+
+	enum EFlags {
+		eFlagRequired            = 0x01,
+		eFlagManagedByYaourt     = 0x02,
+		eFlagExplicitlyInstalled = 0x04
+	};
+	/**
+	 * @brief facets of a package as seen by the filters, a filter hides every package with a hidden facet
+	 */
+	enum EFacets {
+		eFacetStatus            = 0x0001, // one bit per PackageStatus, see statusFacet
+		eFacetExplicit          = 0x0100,
+		eFacetImplicitInstalled = 0x0200, // installed as a dependency
+		eFacetRequiredInstalled = 0x0400,
+		eFacetNotRequired       = 0x0800,
+		eFacetForeign           = 0x1000
+	};
+
+public:
+	PackageStore();
+	PackageStore(const PackageStore&) = delete;
+	PackageStore& operator=(const PackageStore&) = delete;
+
+	/**
+	 * @brief rebuilds all columns, the id of each package will be its index in %packages
+	 * @param packages (not copied, must stay unchanged until the next reset)
+	 * @param repositoryOrder (repositories in order of their priority, others will have the lowest priority)
+	 */
+	void reset(const PackageRepository::TListOfPackages& packages, const QStringList& repositoryOrder);
+
+	/**
+	 * @brief increased on every reset, data derived from the store can be checked against it
+	 */
+	inline quint32 getGeneration() const {
+		return m_generation;
+	}
+
+	inline quint32 size() const {
+		return m_ids.size();
+	}
+	/**
+	 * @brief ids of all packages (0 to size-1)
+	 */
+	inline const TIdList& getIds() const {
+		return m_ids;
+	}
+	inline PackageRepository::PackageData* package(const quint32 id) const {
+		return (*m_packages)[id];
+	}
+
+	inline PackageStatus status(const quint32 id) const {
+		return static_cast<PackageStatus>(m_status[id]);
+	}
+	inline quint8 flags(const quint32 id) const {
+		return m_flags[id];
+	}
+	inline bool hasFlag(const quint32 id, const EFlags flag) const {
+		return (m_flags[id] & flag) != 0;
+	}
+	inline bool installed(const quint32 id) const {
+		return m_status[id] != epkg_NON_INSTALLED;
+	}
+	/**
+	 * @brief EFacets of the package
+	 */
+	inline quint16 facets(const quint32 id) const {
+		return m_facets[id];
+	}
+	static inline quint16 statusFacet(const PackageStatus status) {
+		return eFacetStatus << status;
+	}
+	/**
+	 * @brief index in getRepositories(), repository ids are ordered like the repository names
+	 */
+	inline quint16 repositoryId(const quint32 id) const {
+		return m_repositoryId[id];
+	}
+	/**
+	 * @brief bit of the repository of a package in a repository mask
+	 *
+	 * the repositories from id 63 on share one bit, only exact for up to ctn_MAX_MASKED_REPOSITORIES repositories
+	 */
+	inline quint64 repositoryBit(const quint32 id) const {
+		return quint64(1) << std::min<quint16>(m_repositoryId[id], 63);
+	}
+	/**
+	 * @brief repository mask of %repositories (see repositoryBit), unknown repositories are ignored
+	 */
+	quint64 repositoryMask(const QSet<QString>& repositories) const;
+	/**
+	 * @brief name of the package, only valid until the next reset (no copy)
+	 */
+	inline QString name(const quint32 id) const {
+		return QString::fromRawData(nameData(id), nameLength(id));
+	}
+	inline const QChar* nameData(const quint32 id) const {
+		return m_namePool.constData() + m_nameOffset[id];
+	}
+	inline int nameLength(const quint32 id) const {
+		return m_nameOffset[id + 1] - m_nameOffset[id];
+	}
+	inline bool nameEquals(const quint32 id, const QChar* data, const int length) const {
+		return nameLength(id) == length && memcmp(nameData(id), data, length * sizeof(QChar)) == 0;
+	}
+	/**
+	 * @brief ids of all packages called %name ordered by repository priority (see PackageNameIndex)
+	 */
+	inline PackageNameIndex::TIdRange findByName(const QString& name) const {
+		return m_nameIndex.find(name);
+	}
+	/**
+	 * @brief compares the versions of two packages, see Pacman::versionKey
+	 */
+	inline int compareVersions(const quint32 a, const quint32 b) const {
+		const int lengthA = m_versionKeyOffset[a + 1] - m_versionKeyOffset[a];
+		const int lengthB = m_versionKeyOffset[b + 1] - m_versionKeyOffset[b];
+		const int cmp = memcmp(m_versionKeys.constData() + m_versionKeyOffset[a],
+		                       m_versionKeys.constData() + m_versionKeyOffset[b], std::min(lengthA, lengthB));
+		if (cmp != 0) return cmp < 0 ? -1 : 1;
+		return lengthA < lengthB ? -1 : (lengthA > lengthB ? 1 : 0);
+	}
+
+	/**
+	 * @brief all distinct repositories sorted by name
+	 */
+	inline const QStringList& getRepositories() const {
+		return m_repositories;
+	}
+	/**
+	 * @return -1 if there is no package in %repository
+	 */
+	int findRepositoryId(const QString& repository) const;
+	/**
+	 * @brief priority of the repository of a package, 0 is the highest priority (see pacman.conf)
+	 */
+	inline quint16 repositoryPriority(const quint32 id) const {
+		return m_repositoryPriority[m_repositoryId[id]];
+	}
+
+private:
+	quint32                            m_generation;
+	const PackageRepository::TListOfPackages* m_packages; // WEAK, the package list of the repository
+	TIdList                            m_ids;
+	// columns
+	std::vector<quint8>                m_status;
+	std::vector<quint8>                m_flags;
+	std::vector<quint16>               m_facets;
+	std::vector<quint16>               m_repositoryId;
+	std::vector<quint32>               m_nameOffset;       // size + 1 entries, in QChars
+	QString                            m_namePool;
+	PackageNameIndex                   m_nameIndex;
+	std::vector<quint32>               m_versionKeyOffset; // size + 1 entries
+	QByteArray                         m_versionKeys;
+	// repositories
+	QStringList                        m_repositories;
+	QHash<QString, int>                m_repositoryIds;
+	std::vector<quint16>               m_repositoryPriority; // by repository id
+};
+
+#endif // PACKAGESTORE_H
@@ -0,0 +1,116 @@
+/*
+* This file is part of pakman, an open-source GUI for pacman.
+* Copyright (C) 2014 Thomas Binkau
+*
+* This program is free software; you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation; either version 2 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+*
+*/
+
+#include "providesindex.h"
+
+#include <algorithm>
+
+#include "src/data/packagestore.h"
+
+
+namespace {
+
+/**
+ * @brief installed first, then repository priority, then id
+ */
+struct TPreference {
+	TPreference(const PackageStore& packageStore)
+		: store(packageStore)
+	{}
+
+	bool operator()(const ProvidesIndex::Provider& a, const ProvidesIndex::Provider& b) const {
+		const bool installedA = store.installed(a.id);
+		const bool installedB = store.installed(b.id);
+		if (installedA != installedB) return installedA;
+		const quint16 priorityA = store.repositoryPriority(a.id);
+		const quint16 priorityB = store.repositoryPriority(b.id);
+		if (priorityA != priorityB) return priorityA < priorityB;
+		return a.id < b.id;
+	}
+
+	const PackageStore& store;
+};
+
+}
+
+
+ProvidesIndex::ProvidesIndex()
+	: m_store(nullptr), m_generation(0)
+{
+}
+
+void ProvidesIndex::reset(const PackageStore& store)
+{
+	m_store      = &store;
+	m_generation = store.getGeneration();
+	m_providers.clear();
+
+	for (quint32 id = 0; id < store.size(); ++id) {
+		foreach (const QString& provides, store.package(id)->provides) {
+			const DependencyGraph::Relation relation = DependencyGraph::Relation::parse(provides);
+			Provider provider;
+			provider.id      = id;
+			provider.version = relation.version;
+			m_providers[relation.name].push_back(provider);
+		}
+	}
+
+	const TPreference preference(store);
+	for (QHash<QString, TProviders>::iterator it = m_providers.begin(); it != m_providers.end(); ++it) {
+		std::sort(it->begin(), it->end(), preference);
+	}
+}
+
+const ProvidesIndex::TProviders* ProvidesIndex::find(const QString& name) const
+{
+	QHash<QString, TProviders>::const_iterator it = m_providers.find(name);
+	return it != m_providers.end() ? &*it : nullptr;
+}
+
+quint32 ProvidesIndex::resolve(const DependencyGraph::Relation& dependency) const
+{
+	if (m_store == nullptr)
+		return NO_PACKAGE;
+
+	// packages with that name (ordered by repository priority), an installed one is preferred
+	quint32 result = NO_PACKAGE;
+	const PackageNameIndex::TIdRange ids = m_store->findByName(dependency.name);
+	for (quint32 id = ids.first; id < ids.second; ++id) {
+		if (dependency.isSatisfiedBy(m_store->package(id)->version)) {
+			if (m_store->installed(id))
+				return id;
+			if (result == NO_PACKAGE)
+				result = id;
+		}
+	}
+	if (result != NO_PACKAGE)
+		return result;
+
+	const TProviders*const providers = find(dependency.name);
+	if (providers == nullptr)
+		return NO_PACKAGE;
+	for (TProviders::const_iterator it = providers->begin(); it != providers->end(); ++it) {
+		// an unversioned provision satisfies unversioned dependencies only
+		if (dependency.constraint == DependencyGraph::eAny ||
+		    (it->version.isEmpty() == false && dependency.isSatisfiedBy(it->version)))
+			return it->id;
+	}
+	return NO_PACKAGE;
+}
@@ -0,0 +1,80 @@
+/*
+* This file is part of pakman, an open-source GUI for pacman.
+* Copyright (C) 2014 Thomas Binkau
+*
+* This program is free software; you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation; either version 2 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+*
+*/
+
+#ifndef PROVIDESINDEX_H
+#define PROVIDESINDEX_H
+
+#include <vector>
+#include <QHash>
+#include <QString>
+
+#include "src/data/dependencygraph.h"
+
+class PackageStore;
+
+
+/**
+ * @brief Resolves (virtual) package names like "sh" or "libgl" to the packages providing them
+ *
+ * Candidates are ordered by preference: installed packages first, then by repository priority
+ * (pacman.conf), then by id. Built for one generation of a PackageStore.
+ */
+class ProvidesIndex
+{
+public:
+	struct Provider {
+		quint32 id;
+		QString version; // empty if the provision is unversioned
+	};
+	typedef std::vector<Provider> TProviders;
+
+	static const quint32 NO_PACKAGE = 0xFFFFFFFF;
+
+public:
+	ProvidesIndex();
+
+	/**
+	 * @brief rebuilds the index from the provides of all packages in %store
+	 */
+	void reset(const PackageStore& store);
+	/**
+	 * @brief generation of the store (see PackageStore::getGeneration) the index was built for
+	 */
+	inline quint32 getGeneration() const {
+		return m_generation;
+	}
+
+	/**
+	 * @return all providers of %name (without packages called %name) in order of preference, nullptr if none
+	 */
+	const TProviders* find(const QString& name) const;
+	/**
+	 * @brief best package for %dependency: a package with that name, otherwise a provider (see class description)
+	 * @return NO_PACKAGE if nothing satisfies %dependency
+	 */
+	quint32 resolve(const DependencyGraph::Relation& dependency) const;
+
+private:
+	const PackageStore*        m_store;
+	quint32                    m_generation;
+	QHash<QString, TProviders> m_providers;
+};
+
+#endif // PROVIDESINDEX_H
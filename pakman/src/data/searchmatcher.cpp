@@ -0,0 +1,293 @@
+/*
+* This file is part of pakman, an open-source GUI for pacman.
+* Copyright (C) 2014 Thomas Binkau
+*
+* This program is free software; you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation; either version 2 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+*
+*/
+
+#include "searchmatcher.h"
+
+#include <atomic>
+#include <QHash>
+#include <QMutex>
+#include <QMutexLocker>
+
+
+namespace {
+
+// every key stroke compiles a new text, the cache is dropped as a whole once it is full
+const int ctn_MAX_CACHED_MATCHERS = 64;
+
+#if QT_VERSION < 0x050000
+// identifies a matcher for the per thread copies of its QRegExp (0 == none)
+std::atomic<quint64> s_lastSerial(0);
+#endif
+
+inline ushort fold(const ushort c)
+{
+	return ushort(c - 'A') < 26 ? ushort(c | 0x20) : c;
+}
+
+/**
+ * @param needle (lower case)
+ */
+inline bool equalFolded(const ushort c, const ushort needle)
+{
+	return fold(c) == needle || (needle >= 0x80 && QChar(c).toLower().unicode() == needle);
+}
+
+/**
+ * @brief true if the text (without anchors) needs the regular expression engine
+ */
+inline bool isRegExp(const QString& text)
+{
+	static const QString special("\\.+()[]{}|^$");
+	foreach (const QChar c, text) {
+		if (special.contains(c))
+			return true;
+	}
+	return false;
+}
+
+/**
+ * @brief literal parts of a regular expression every match must contain ("foo.bar" -> foo, bar)
+ * @return false if the text can not be reduced to required literals (alternatives, groups, classes, escapes)
+ */
+bool requiredLiterals(const QString& text, QStringList& literals)
+{
+	static const QString unsupported("|\\([{");
+	static const QString separators(".*+?^$");
+	literals.clear();
+	QString literal;
+	foreach (const QChar c, text) {
+		if (unsupported.contains(c))
+			return false;
+		if (separators.contains(c) == false) {
+			literal += c;
+			continue;
+		}
+		// the character in front of '*' is optional
+		if (c == '*') literal.chop(1);
+		if (literal.isEmpty() == false) literals << literal;
+		literal.clear();
+	}
+	if (literal.isEmpty() == false) literals << literal;
+	return true;
+}
+
+/*
+ * Returns a modified RegExp-based string given the string entered by the user
+ *
+ * from Octopi
+ */
+QString adaptSearchString(QString searchStr, bool exactMatch)
+{
+  if (searchStr.indexOf("*.") == 0){
+    searchStr = searchStr.remove(0, 2);
+    searchStr.insert(0, "\\S+\\.");
+  }
+
+  if (searchStr.indexOf("*") == 0){
+    searchStr = searchStr.remove(0, 1);
+    searchStr.insert(0, "\\S+");
+  }
+
+  if (searchStr.endsWith("*")){
+    searchStr.remove(searchStr.length()-1, 1);
+    searchStr.append("\\S*");
+  }
+
+  if (searchStr.indexOf("^") == -1 && searchStr.indexOf("\\S") != 0){
+    if (!exactMatch) searchStr.insert(0, "\\S*");
+    else searchStr.insert(0, "^");
+  }
+
+  if (searchStr.indexOf("$") == -1){
+    if (!exactMatch && !searchStr.endsWith("\\S*")) searchStr.append("\\S*");
+    else searchStr.append("$");
+  }
+
+  searchStr.replace("?", ".");
+  return searchStr;
+}
+
+}
+
+
+std::shared_ptr<const SearchMatcher> SearchMatcher::compile(const QString& text)
+{
+	static QMutex mutex;
+	static QHash<QString, std::shared_ptr<const SearchMatcher>> cache;
+
+	QMutexLocker lock(&mutex);
+	QHash<QString, std::shared_ptr<const SearchMatcher>>::const_iterator it = cache.find(text);
+	if (it != cache.end())
+		return *it;
+
+	if (cache.size() >= ctn_MAX_CACHED_MATCHERS) cache.clear();
+	std::shared_ptr<const SearchMatcher> matcher(new SearchMatcher(text));
+	cache.insert(text, matcher);
+	return matcher;
+}
+
+SearchMatcher::SearchMatcher(const QString& text)
+	: m_kind(eMatchAll), m_text(text), m_anchoredStart(false), m_anchoredEnd(false)
+#if QT_VERSION < 0x050000
+	, m_serial(++s_lastSerial)
+#endif
+{
+	QString core = text;
+	const bool anchoredStart = core.startsWith('^');
+	if (anchoredStart) core.remove(0, 1);
+	const bool anchoredEnd = core.endsWith('$');
+	if (anchoredEnd) core.chop(1);
+
+	if (isRegExp(core)) {
+		m_kind = eRegExp;
+		if (requiredLiterals(text, m_requiredLiterals) == false)
+			m_requiredLiterals.clear();
+#if QT_VERSION >= 0x050000
+		m_regExp.setPattern(adaptSearchString(text, false));
+		m_regExp.setPatternOptions(QRegularExpression::CaseInsensitiveOption);
+#if QT_VERSION >= 0x050400
+		m_regExp.optimize();
+#endif
+#else
+		m_regExp = QRegExp(adaptSearchString(text, false), Qt::CaseInsensitive, QRegExp::RegExp);
+#endif
+		return;
+	}
+
+	// '*' separates the segments, a leading or trailing '*' cancels the anchor
+	const QStringList parts = core.split('*');
+	m_anchoredStart = anchoredStart && parts.first().isEmpty() == false;
+	m_anchoredEnd   = anchoredEnd && parts.last().isEmpty() == false;
+	foreach (const QString& part, parts) {
+		if (part.isEmpty()) continue;
+		Segment segment;
+		segment.text     = part.toLower();
+		segment.wildcard = part.contains('?');
+		m_segments.push_back(segment);
+		m_requiredLiterals << part.split('?', QString::SkipEmptyParts);
+	}
+
+	if (m_segments.empty())
+		m_kind = eMatchAll;
+	else if (parts.size() == 1 && m_segments.front().wildcard == false && m_anchoredEnd == false)
+		m_kind = m_anchoredStart ? ePrefix : eLiteral;
+	else
+		m_kind = eGlob;
+}
+
+bool SearchMatcher::matches(const QChar* text, const int length) const
+{
+	switch (m_kind) {
+	case eMatchAll:
+		return true;
+	case eLiteral:
+		return findSegment(text, length, m_segments.front(), 0) != -1;
+	case ePrefix:
+		return m_segments.front().text.size() <= length && matchesAt(text, m_segments.front());
+	case eGlob:
+		break;
+	case eRegExp:
+#if QT_VERSION >= 0x050000
+		return m_regExp.match(QString::fromRawData(text, length)).hasMatch();
+#else
+	{
+		// QRegExp keeps the state of the last match, every thread matches with its own copy (the engine is
+		// shared), copying it per call would allocate for every package
+		struct ThreadRegExp {
+			quint64 serial;
+			QRegExp regExp;
+		};
+		static thread_local ThreadRegExp local = { 0, QRegExp() };
+		if (local.serial != m_serial) {
+			local.regExp = m_regExp;
+			local.serial = m_serial;
+		}
+		return local.regExp.indexIn(QString::fromRawData(text, length)) != -1;
+	}
+#endif
+	}
+
+	// the leftmost occurrence of each segment leaves the most room for the following ones
+	const std::size_t count = m_segments.size();
+	int position = 0;
+	for (std::size_t x = 0; x < count; ++x) {
+		const Segment& segment = m_segments[x];
+		const int segmentLength = segment.text.size();
+		if (x == 0 && m_anchoredStart) {
+			if (segmentLength > length || matchesAt(text, segment) == false)
+				return false;
+			position = segmentLength;
+		}
+		else if (x + 1 == count && m_anchoredEnd) {
+			const int start = length - segmentLength;
+			return start >= position && matchesAt(text + start, segment);
+		}
+		else {
+			const int found = findSegment(text, length, segment, position);
+			if (found == -1)
+				return false;
+			position = found + segmentLength;
+		}
+	}
+	// a single anchored segment
+	return m_anchoredEnd == false || position == length;
+}
+
+bool SearchMatcher::isRefinementOf(const SearchMatcher& previous) const
+{
+	if (previous.m_kind == eMatchAll || m_text == previous.m_text)
+		return true;
+
+	// starting with / containing the longer text implies containing the previous text
+	if (previous.m_kind == eLiteral && (m_kind == eLiteral || m_kind == ePrefix))
+		return m_segments.front().text.contains(previous.m_segments.front().text);
+	if (previous.m_kind == ePrefix && m_kind == ePrefix)
+		return m_segments.front().text.startsWith(previous.m_segments.front().text);
+	return false;
+}
+
+/**
+ * @brief true if %segment matches the characters at %text (at least as many as the segment has)
+ */
+bool SearchMatcher::matchesAt(const QChar* text, const Segment& segment)
+{
+	const ushort* chars  = reinterpret_cast<const ushort*>(text);
+	const ushort* needle = segment.text.utf16();
+	for (int x = 0; x < segment.text.size(); ++x) {
+		if ((segment.wildcard == false || needle[x] != '?') && equalFolded(chars[x], needle[x]) == false)
+			return false;
+	}
+	return true;
+}
+
+/**
+ * @return first position >= %from where %segment matches, -1 if none
+ */
+int SearchMatcher::findSegment(const QChar* text, const int length, const Segment& segment, const int from)
+{
+	if (segment.wildcard) {
+		for (int x = from; x + segment.text.size() <= length; ++x) {
+			if (matchesAt(text + x, segment))
+				return x;
+		}
+		return -1;
+	}
+	return QString::fromRawData(text, length).indexOf(segment.text, from, Qt::CaseInsensitive);
+}
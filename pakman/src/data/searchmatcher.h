@@ -0,0 +1,112 @@
+/*
+* This file is part of pakman, an open-source GUI for pacman.
+* Copyright (C) 2014 Thomas Binkau
+*
+* This program is free software; you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation; either version 2 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+*
+*/
+
+#ifndef SEARCHMATCHER_H
+#define SEARCHMATCHER_H
+
+#include <memory>
+#include <vector>
+#include <QString>
+#include <QStringList>
+#if QT_VERSION >= 0x050000
+#include <QRegularExpression>
+#else
+#include <QRegExp>
+#endif
+
+
+/**
+ * @brief Search text as entered by the user, compiled to the cheapest way of matching it (case insensitive)
+ *
+ * - literal ("foo"):          substring
+ * - prefix ("^foo"):          start of the text
+ * - glob ("foo*bar", "f?o$"): substrings in order, '*' any characters, '?' one character, optional anchors
+ * - regular expression:       everything else (QRegularExpression with Qt 5, QRegExp with Qt 4)
+ *
+ * Matchers are immutable and cached by their search text (see compile), matches may be called by
+ * several threads at once.
+ */
+class SearchMatcher
+{
+public:
+	enum EKind {
+		eMatchAll, // empty search text
+		eLiteral,
+		ePrefix,
+		eGlob,
+		eRegExp
+	};
+
+public:
+	/**
+	 * @brief the (cached) matcher of %text, thread safe
+	 */
+	static std::shared_ptr<const SearchMatcher> compile(const QString& text);
+
+	inline EKind getKind() const {
+		return m_kind;
+	}
+	inline const QString& getText() const {
+		return m_text;
+	}
+	/**
+	 * @brief literal parts every matching text must contain (case as entered), empty if unknown
+	 */
+	inline const QStringList& getRequiredLiterals() const {
+		return m_requiredLiterals;
+	}
+
+	bool matches(const QChar* text, const int length) const;
+	inline bool matches(const QString& text) const {
+		return matches(text.constData(), text.size());
+	}
+	/**
+	 * @brief true if every text matching this also matches %previous
+	 */
+	bool isRefinementOf(const SearchMatcher& previous) const;
+
+private:
+	explicit SearchMatcher(const QString& text);
+
+	struct Segment {
+		QString text;     // lower case
+		bool    wildcard; // contains '?'
+	};
+	static bool matchesAt(const QChar* text, const Segment& segment);
+	static int findSegment(const QChar* text, const int length, const Segment& segment, const int from);
+
+private:
+	EKind                m_kind;
+	QString              m_text;
+	QStringList          m_requiredLiterals;
+	// literal, prefix and glob
+	std::vector<Segment> m_segments;
+	bool                 m_anchoredStart;
+	bool                 m_anchoredEnd;
+	// regular expression
+#if QT_VERSION >= 0x050000
+	QRegularExpression   m_regExp;
+#else
+	QRegExp              m_regExp;
+	quint64              m_serial; // see matches
+#endif
+};
+
+#endif // SEARCHMATCHER_H
@@ -0,0 +1,114 @@
+/*
+* This file is part of pakman, an open-source GUI for pacman.
+* Copyright (C) 2014 Thomas Binkau
+*
+* This program is free software; you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation; either version 2 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+*
+*/
+
+#include "trigramindex.h"
+
+#include <algorithm>
+#include <iterator>
+#include <utility>
+
+
+TrigramIndex::TrigramIndex()
+	: m_offsets(1, 0)
+{
+}
+
+void TrigramIndex::clear()
+{
+	m_pending.clear();
+	m_keys.clear();
+	m_offsets.assign(1, 0);
+	m_ids.clear();
+}
+
+void TrigramIndex::add(const quint32 id, const char* text, const int length)
+{
+	for (int x = 0; x + 3 <= length; ++x) {
+		m_pending.push_back((quint64(trigram(text + x)) << 32) | id);
+	}
+}
+
+void TrigramIndex::finish()
+{
+	// sorted by trigram, then id; duplicates are trigrams occurring more than once in a document
+	std::sort(m_pending.begin(), m_pending.end());
+	m_pending.erase(std::unique(m_pending.begin(), m_pending.end()), m_pending.end());
+
+	m_keys.clear();
+	m_offsets.clear();
+	m_ids.clear();
+	m_ids.reserve(m_pending.size());
+	for (std::vector<quint64>::const_iterator it = m_pending.begin(); it != m_pending.end(); ++it) {
+		const quint32 key = *it >> 32;
+		if (m_keys.empty() || m_keys.back() != key) {
+			m_keys.push_back(key);
+			m_offsets.push_back(m_ids.size());
+		}
+		m_ids.push_back(quint32(*it));
+	}
+	m_offsets.push_back(m_ids.size());
+	std::vector<quint64>().swap(m_pending);
+}
+
+bool TrigramIndex::findCandidates(const char* text, const int length, TIdList& result) const
+{
+	result.clear();
+	if (length < 3)
+		return false;
+
+	// posting lists of all trigrams, the shortest first
+	std::vector<std::pair<const quint32*, const quint32*>> lists;
+	for (int x = 0; x + 3 <= length; ++x) {
+		const std::vector<quint32>::const_iterator key = std::lower_bound(m_keys.begin(), m_keys.end(), trigram(text + x));
+		if (key == m_keys.end() || *key != trigram(text + x))
+			return true; // no document contains this trigram
+		const std::size_t index = key - m_keys.begin();
+		lists.push_back(std::make_pair(m_ids.data() + m_offsets[index], m_ids.data() + m_offsets[index + 1]));
+	}
+	std::sort(lists.begin(), lists.end(), [](const std::pair<const quint32*, const quint32*>& a,
+	                                         const std::pair<const quint32*, const quint32*>& b) {
+		return a.second - a.first < b.second - b.first;
+	});
+
+	result.assign(lists.front().first, lists.front().second);
+	TIdList intersection;
+	for (std::size_t x = 1; x < lists.size() && result.empty() == false; ++x) {
+		if (lists[x] == lists[x - 1]) continue; // same trigram
+		intersection.clear();
+		std::set_intersection(result.begin(), result.end(), lists[x].first, lists[x].second,
+		                      std::back_inserter(intersection));
+		result.swap(intersection);
+	}
+	return true;
+}
+
+bool TrigramIndex::containsFolded(const char* text, const int length, const char* pattern, const int patternLength)
+{
+	if (patternLength == 0)
+		return true;
+
+	for (int x = 0; x + patternLength <= length; ++x) {
+		int y = 0;
+		while (y < patternLength && fold(text[x + y]) == fold(pattern[y])) ++y;
+		if (y == patternLength)
+			return true;
+	}
+	return false;
+}
@@ -0,0 +1,87 @@
+/*
+* This file is part of pakman, an open-source GUI for pacman.
+* Copyright (C) 2014 Thomas Binkau
+*
+* This program is free software; you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation; either version 2 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+*
+*/
+
+#ifndef TRIGRAMINDEX_H
+#define TRIGRAMINDEX_H
+
+#include <vector>
+#include <QtGlobal>
+
+
+/**
+ * @brief Posting lists of all (case folded) byte trigrams of a set of documents
+ *
+ * Used to find the candidates for a substring search: a document can only contain a text if it
+ * contains all trigrams of the text. The candidates must be verified by the caller.
+ * Folding is ASCII only, utf8 sequences are indexed byte by byte.
+ */
+class TrigramIndex
+{
+public:
+	typedef std::vector<quint32> TIdList;
+
+public:
+	TrigramIndex();
+
+	/**
+	 * @brief removes all documents
+	 */
+	void clear();
+	/**
+	 * @brief adds the trigrams of the document %id, finish() must be called after the last document
+	 */
+	void add(const quint32 id, const char* text, const int length);
+	/**
+	 * @brief builds the posting lists of all added documents
+	 */
+	void finish();
+
+	/**
+	 * @brief ids (ascending) of all documents containing every trigram of %text
+	 * @return false if %text is too short to restrict the documents (result is left empty)
+	 */
+	bool findCandidates(const char* text, const int length, TIdList& result) const;
+
+	inline std::size_t countPostings() const {
+		return m_ids.size();
+	}
+
+	static inline char fold(const char c) {
+		return (c >= 'A' && c <= 'Z') ? c + ('a' - 'A') : c;
+	}
+	/**
+	 * @brief true if %text contains %pattern (both folded, see fold)
+	 */
+	static bool containsFolded(const char* text, const int length, const char* pattern, const int patternLength);
+
+private:
+	static inline quint32 trigram(const char* text) {
+		return (quint32(quint8(fold(text[0]))) << 16) | (quint32(quint8(fold(text[1]))) << 8) |
+		       quint32(quint8(fold(text[2])));
+	}
+
+private:
+	std::vector<quint64> m_pending; // (trigram << 32 | id) until finish
+	std::vector<quint32> m_keys;    // sorted trigrams
+	std::vector<quint32> m_offsets; // m_keys.size() + 1 entries
+	std::vector<quint32> m_ids;     // posting lists, ascending per trigram
+};
+
+#endif // TRIGRAMINDEX_H
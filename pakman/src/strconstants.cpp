@@ -77,6 +77,22 @@ QString strCacheDir()
 	return QString(".cache/%1/").arg(strAppName());
 }
 
+/**
+ * @brief pacman configuration (repositories, database path)
+ */
+QString strPacmanConfig()
+{
+	return "/etc/pacman.conf";
+}
+
+/**
+ * @brief default pacman database path (may be overridden by DBPath in pacman.conf)
+ */
+QString strPacmanDatabaseDir()
+{
+	return "/var/lib/pacman/";
+}
+
 /**
  * @brief used for static application data (e.g. the help)
  */
@@ -173,6 +189,22 @@ QString strPacmanGroupToolTip()
 	return QObject::tr("contains all pacman groups");
 }
 
+/**
+ * @brief context menu of the groups tab (intersection instead of union of the selected groups)
+ */
+QString strGroupsMatchAll()
+{
+	return QObject::tr("only packages in all selected groups");
+}
+
+/**
+ * @brief context menu of the groups tab
+ */
+QString strGroupExclude()
+{
+	return QObject::tr("exclude packages of this group");
+}
+
 /**
  * @brief used for Repos filter tab
  */
@@ -494,19 +526,40 @@ QString strCapitalUpgradeSize()
 }
 
 /**
- * @brief used for status bar
+ * @brief result of the what provides me dialog (%1 path, %2 packages)
  */
-QString strTaskLoadingForeignPackages()
+QString strFileOwnedBy()
 {
-	return QObject::tr("loading foreign packages");
+	return QObject::tr("%1 is owned by %2");
+}
+
+/**
+ * @brief result of the what provides me dialog (%1 path)
+ */
+QString strFileNotOwned()
+{
+	return QObject::tr("No package owns %1");
+}
+
+/**
+ * @brief shown by the what provides me dialog until the file lists are loaded
+ */
+QString strFileOwnershipPending()
+{
+	return QObject::tr("The file lists are being loaded, the result follows as soon as they are ready");
 }
 
 /**
  * @brief used for status bar
  */
-QString strTaskLoadingGroups()
+QString strTaskLoadingFileOwnership()
+{
+	return QObject::tr("loading file lists");
+}
+
+QString strTaskLoadingForeignPackages()
 {
-	return QObject::tr("loading groups");
+	return QObject::tr("loading foreign packages");
 }
 
 /**
@@ -525,6 +578,15 @@ QString strTaskLoadingPackages()
 {
 	return QObject::tr("loading packages");
 }
+
+/**
+ * @brief used for status bar (search by file)
+ */
+QString strTaskLoadingSyncFiles()
+{
+	return QObject::tr("loading repository file lists");
+}
+
 /**
  * @brief used for status bar when running pacman-install
  */
@@ -557,14 +619,6 @@ QString strTaskUpdateAurInfo()
 	return QObject::tr("synchronizing foreign repo");
 }
 
-/**
- * @brief used for status bar
- */
-QString strTaskUpdateGroupMembers()
-{
-	return QObject::tr("updating group");
-}
-
 /**
  * @brief used for status bar when fetching data for the info tab
  */
@@ -621,6 +675,15 @@ QString strPackageTotal()
 	return QObject::tr("total");
 }
 
+/**
+ * @brief tooltip of the packages total (%1 KiB used, %2 KiB reserved, %3 blocks, %4 allocations, %5 generations)
+ */
+QString strPackageMemory()
+{
+	return QObject::tr("Package data: %1 KiB used of %2 KiB reserved in %3 blocks (%4 allocations), "
+	                   "%5 generations retired");
+}
+
 /**
  * @brief packages installed shown as: %number installed
  */
@@ -653,6 +716,14 @@ QString strErrorAlreadyRunning()
 	return "already running";
 }
 
+/**
+ * @brief error message "could not read pacman database" %file
+ */
+QString strErrorCanNotReadDatabase()
+{
+	return "could not read pacman database";
+}
+
 /**
  * @brief will be shown if the distibution news can not be shown (non available, processing error)
  */
@@ -699,13 +770,6 @@ QString strErrorDnfInstallationOrDataFile()
 	return "was not installed correctly. please re-install.";
 }
 
-/**
- * @brief error message "did not find package group" %x
- */
-QString strErrorDnfPackageGroup() {
-	return "did not find package group";
-}
-
 /**
  * @brief error message (indicating programming error)
  */
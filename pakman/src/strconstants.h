@@ -33,6 +33,8 @@ const char* strGitHomepage();
 QString     strForeignRepository();
 QString     strPacmanGroup();
 QString     strCacheDir();
+QString     strPacmanConfig();
+QString     strPacmanDatabaseDir();
 QString     strDocumentationDir();
 QString     strScriptsDir();
 const char* strSystemInstallScript();
@@ -51,6 +53,8 @@ QString strVersion();
 
 /// Groups
 QString strPacmanGroupToolTip();
+QString strGroupsMatchAll();
+QString strGroupExclude();
 
 /// Repos
 QString strRepositories();
@@ -98,16 +102,21 @@ QString strRepo();
 QString strCapitalDownloadSize();
 QString strCapitalUpgradeSize();
 
+/// What provides me
+QString strFileOwnedBy();
+QString strFileNotOwned();
+QString strFileOwnershipPending();
+
 /// Tasks
+QString strTaskLoadingFileOwnership();
 QString strTaskLoadingForeignPackages();
-QString strTaskLoadingGroups();
 QString strTaskLoadingNews();
 QString strTaskLoadingPackages();
+QString strTaskLoadingSyncFiles();
 QString strTaskSystemInstall();
 QString strTaskSystemUpgrade();
 QString strTaskSynchronizeRepo();
 QString strTaskUpdateAurInfo();
-QString strTaskUpdateGroupMembers();
 QString strTaskUpdatePackageInfo();
 QString strTaskUpdateReport();
 
@@ -118,11 +127,13 @@ QString strPackageInstalled();
 QString strPackageOutdated();
 QString strPackageSelected();
 QString strPackageTotal();
+QString strPackageMemory();
 QString strStatusLoading();
 QString strStatusReady();
 
 /// Error messages (not translated unless stated otherwise)
 QString strErrorAlreadyRunning();
+QString strErrorCanNotReadDatabase();
 QString strErrorCanNotLoadNews(); // translated
 QString strErrorCanNotShutDown(); // translated
 QString strErrorDoNotRunAsRoot();
@@ -131,7 +142,6 @@ QString strErrorDnfAUR404();
 QString strErrorDnfDistributionNews404();
 QString strErrorDnfDependencyInfo(const QString& packageName);
 QString strErrorDnfInstallationOrDataFile();
-QString strErrorDnfPackageGroup();
 
 /// Confirmation Dialog
 QString strDlgRunningTransactions();
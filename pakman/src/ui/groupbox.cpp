@@ -21,13 +21,16 @@
 #include "src/ui/groupbox.h"
 #include "ui_groupbox.h"
 
+#include <QMenu>
 #include <QTableWidgetItem>
+#include <QTreeWidgetItemIterator>
+#include "src/data/packagestore.h"
 #include "src/strconstants.h"
 #include "src/icons.h"
 
 
 GroupBox::GroupBox(QWidget *parent)
-	: QWidget(parent), ui(new Ui::GroupBox), m_repo(nullptr)
+	: QWidget(parent), ui(new Ui::GroupBox), m_repo(nullptr), m_matchAllGroups(false)
 {
 	ui->setupUi(this);
 }
@@ -45,6 +48,9 @@ void GroupBox::initialize(PackageRepository& repo)
 	connect(this, SIGNAL(updateViewSignal(bool)), this, SLOT(updateView(bool)), Qt::QueuedConnection);
 	connect(ui->twGroups->selectionModel(), SIGNAL(selectionChanged(QItemSelection,QItemSelection)),
 	        this, SLOT(groupSelectionChanged(QItemSelection,QItemSelection)), Qt::AutoConnection);
+	ui->twGroups->setContextMenuPolicy(Qt::CustomContextMenu);
+	connect(ui->twGroups, SIGNAL(customContextMenuRequested(QPoint)),
+	        this, SLOT(groupsContextMenuRequested(QPoint)));
 
 	// Repo Filter Widget
 	ui->twRepos->setColumnWidth(0, 26);
@@ -98,10 +104,10 @@ void GroupBox::updateView(bool invalidate)
 			}
 		}
 		ui->twGroups->expandItem(pacman);
+		updateView_markExcludedGroups();
 
 		// Repo Filter Widget
-		auto repoList = m_repo->getRepos().toList().toStdList();
-		repoList.sort();
+		auto repoList = m_repo->getStore().getRepositories().toStdList(); // sorted by name
 		m_repoFilter = addSettingsGroup(*ui->twRepos, iconRepository(), strRepositories(),
 		                                repoList, Qt::Unchecked);
 
@@ -111,22 +117,57 @@ void GroupBox::updateView(bool invalidate)
 
 void GroupBox::groupSelectionChanged(const QItemSelection&, const QItemSelection&)
 {
-	auto list = ui->twGroups->selectedItems();
-	if (list.isEmpty() == false) {
-		GroupItem* item = static_cast<GroupItem*>(list.first());
-		if (item->parent()) {
-			emit groupSelected(item->getName());
-			m_filter.applyGroupFilter(item->getName());
-			emit filterUpdate(&m_filter);
-			return;
-		}
+	applyGroupFilter();
+	emit filterUpdate(&m_filter);
+}
+
+void GroupBox::groupsContextMenuRequested(const QPoint& pt)
+{
+	QMenu menu(this);
+	QAction*const matchAll = menu.addAction(strGroupsMatchAll());
+	matchAll->setCheckable(true);
+	matchAll->setChecked(m_matchAllGroups);
+
+	// artificial groups (like pacman) can not be excluded
+	GroupItem*const item = static_cast<GroupItem*>(ui->twGroups->itemAt(pt));
+	QAction* exclude = nullptr;
+	if (item != nullptr && item->parent()) {
+		exclude = menu.addAction(strGroupExclude());
+		exclude->setCheckable(true);
+		exclude->setChecked(m_excludedGroups.contains(item->getName()));
 	}
 
-	// no group or artificial group (like pacman) selected -> no filter
-	m_filter.applyGroupFilter(QString());
+	QAction*const action = menu.exec(ui->twGroups->viewport()->mapToGlobal(pt));
+	if (action == nullptr)
+		return;
+	if (action == matchAll) {
+		m_matchAllGroups = matchAll->isChecked();
+	}
+	else if (action == exclude) {
+		if (exclude->isChecked()) m_excludedGroups.insert(item->getName());
+		else m_excludedGroups.remove(item->getName());
+		updateView_markExcludedGroups();
+	}
+
+	applyGroupFilter();
 	emit filterUpdate(&m_filter);
 }
 
+void GroupBox::applyGroupFilter()
+{
+	// no group or artificial group (like pacman) selected -> no restriction
+	QStringList groups;
+	foreach (QTreeWidgetItem* item, ui->twGroups->selectedItems()) {
+		if (item->parent())
+			groups << static_cast<GroupItem*>(item)->getName();
+	}
+
+	m_filter.applyGroupFilter(groups,
+	                          m_matchAllGroups ? DefaultPackageFilter::eMatchAllGroups
+	                                           : DefaultPackageFilter::eMatchAnyGroup,
+	                          m_excludedGroups.toList());
+}
+
 void GroupBox::reposCellClicked(int row, int column)
 {
 	if (column != 0 || m_repoFilter == nullptr || m_repoFilter->isIndexIncluded(row) == false)
@@ -143,11 +184,11 @@ void GroupBox::reposCellClicked(int row, int column)
 
 	if (repos.size() == m_repoFilter->getItemCount()) {
 		// all repos included
-		if (m_filter.applyFilter(QSet<QString>()) == false) return;
+		if (m_filter.applyFilter(QSet<QString>(), m_repo->getStore()) == false) return;
 	}
 	else {
 		// construct filter
-		if (m_filter.applyFilter(std::move(repos)) == false) return;
+		if (m_filter.applyFilter(std::move(repos), m_repo->getStore()) == false) return;
 	}
 
 	emit filterUpdate(&m_filter);
@@ -291,6 +332,16 @@ GroupBox::GroupItem* GroupBox::updateView_tryAddGroup(GroupItem*const lastItem,
 	}
 }
 
+void GroupBox::updateView_markExcludedGroups()
+{
+	for (QTreeWidgetItemIterator it(ui->twGroups); *it; ++it) {
+		GroupItem*const item = static_cast<GroupItem*>(*it);
+		QFont font(item->font(0));
+		font.setStrikeOut(m_excludedGroups.contains(item->getName()));
+		item->setFont(0, font);
+	}
+}
+
 void GroupBox::invalidateView()
 {
 	ui->twGroups->clear();
@@ -325,24 +376,12 @@ std::unique_ptr<GroupBox::SettingsGroup> GroupBox::addSettingsGroup(QTableWidget
 	return std::unique_ptr<SettingsGroup>(new SettingsGroup(tw, row, items.size()));
 }
 
-void GroupBox::beginResetRepository(PackageRepository::EResetType type)
+void GroupBox::beginResetRepository(PackageRepository::EResetType)
 {
-	switch (type) {
-	default:
-		emit updateViewSignal(true);
-	case PackageRepository::eResetGroupMembers:
-		//DO NOTHING
-		return;
-	}
+	emit updateViewSignal(true);
 }
 
-void GroupBox::endResetRepository(PackageRepository::EResetType type)
+void GroupBox::endResetRepository(PackageRepository::EResetType)
 {
-	switch (type) {
-	default:
-		emit updateViewSignal(false);
-	case PackageRepository::eResetGroupMembers:
-		//DO NOTHING
-		return;
-	}
+	emit updateViewSignal(false);
 }
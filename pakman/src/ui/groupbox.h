@@ -113,12 +113,12 @@ public:
 signals:
 	void filterUpdate(const DefaultPackageFilter* newFilter);
 	void updateViewSignal(bool invalidate);
-	void groupSelected(QString groupName); // will not notify on all group or other special purpose groups / deselection
 
 private slots:
 	// invalidate true will clear only, false will rebuild
 	void updateView(bool invalidate);
 	void groupSelectionChanged(const QItemSelection&, const QItemSelection&);
+	void groupsContextMenuRequested(const QPoint& pt);
 	void reposCellClicked(int row, int column);
 	void reposCellDoubleClicked(int row, int column);
 	void filterCellClicked(int row, int column);
@@ -132,6 +132,14 @@ private:
 	 * @return the future parent for the next round or nullptr if it must be added as first level item
 	 */
 	GroupItem* updateView_tryAddGroup(GroupItem*const lastItem, const QString& group);
+	/**
+	 * @brief shows excluded groups struck out
+	 */
+	void updateView_markExcludedGroups();
+	/**
+	 * @brief applies selected / excluded groups to the filter (does not emit filterUpdate)
+	 */
+	void applyGroupFilter();
 	/**
 	 * @brief invalidates Groups and Repos. Filter settings will remain
 	 */
@@ -157,6 +165,8 @@ private:
 	std::unique_ptr<SettingsGroup> m_outdatedFilter;
 	std::unique_ptr<SettingsGroup> m_necessaryFilter;
 	DefaultPackageFilter m_filter;
+	bool                 m_matchAllGroups; // true = intersection, false = union of selected groups
+	QSet<QString>        m_excludedGroups;
 
 	// IDependency interface
 private:
@@ -25,11 +25,16 @@
 #include <iostream>
 #include <QMessageBox>
 #include <QCloseEvent>
+#include <QDir>
 #include <QFile>
 #include <QTextStream>
+#include <QtConcurrentRun>
 #include "src/ui/lineedit.h"
 #include "src/ui/whatprovidesme.h"
 #include "src/commands/pacman.h"
+#include "src/commands/pacmandatabase.h"
+#include "src/data/fileownershipindex.h"
+#include "src/data/packagestore.h"
 #include "src/strconstants.h"
 #include "src/distribution/distributioninfo.h"
 #include "src/commands/terminal.h"
@@ -39,7 +44,8 @@
 MainWindow::MainWindow(DistributionInfo& distribution, TaskProcessor& cpu,
                        QWidget *parent)
 	: QMainWindow(parent), m_cpu(cpu), m_pkgRepo(), m_distribution(distribution),
-	  ui(new Ui::MainWindow), m_statusbar(new StatusBar())
+	  ui(new Ui::MainWindow), m_statusbar(new StatusBar()),
+	  m_fileOwnershipStamp(0), m_syncFilesStamp(0), m_prefetchCancelled(false), m_prefetchRestart(false)
 {
 	ui->setupUi(this);
 	setWindowTitle(QString(strAppName()) + " v." + strAppVersion());
@@ -54,16 +60,15 @@ MainWindow::MainWindow(DistributionInfo& distribution, TaskProcessor& cpu,
 	// PackageView stage2 - connect signals (package selection)
 	connect(ui->packageView, SIGNAL(selectionChanged(QItemSelection,QItemSelection)),
 	        this, SLOT(selectionChanged(QItemSelection,QItemSelection)));
+	connect(ui->packageView, SIGNAL(rowsEvaluated()), this, SLOT(packageRowsEvaluated()));
 	connect(ui->packageView, SIGNAL(requestContextMenu(QPoint, QList<const PackageRepository::PackageData*>*)),
 	        this, SLOT(onRequestForContextMenu(QPoint, QList<const PackageRepository::PackageData*>*)),
 	        Qt::DirectConnection);
 	connect(ui->actionInstall_now, SIGNAL(triggered()), this, SLOT(actionInstallNow_triggered()));
 	connect(ui->actionRemove_now, SIGNAL(triggered()), this, SLOT(actionRemoveNow_triggered()));
-	// GroupBox stage2 - connect signals (group selection, deferred loading)
+	// GroupBox stage2 - connect signals (group selection)
 	connect(ui->groupBox, SIGNAL(filterUpdate(const DefaultPackageFilter*)),
 	        this, SLOT(filterChanged(const DefaultPackageFilter*)));
-	connect(ui->groupBox, SIGNAL(groupSelected(QString)),
-	        this, SLOT(loadGroupMemberList(QString)));
 
 	//TODO prototype: Searchbar
 	QWidget* menuWidget = new QWidget();
@@ -82,6 +87,7 @@ MainWindow::MainWindow(DistributionInfo& distribution, TaskProcessor& cpu,
 	QActionGroup* actionGroup = new QActionGroup(this); // WEAK
 	actionGroup->addAction(ui->actionSearchByDescription);
 	actionGroup->addAction(ui->actionSearchByName);
+	actionGroup->addAction(ui->actionSearchByFile);
 	actionGroup->setExclusive(true);
 
 	connect(actionGroup, SIGNAL(triggered(QAction*)),
@@ -91,13 +97,20 @@ MainWindow::MainWindow(DistributionInfo& distribution, TaskProcessor& cpu,
 	// StatusBar
 	connect(m_statusbar, SIGNAL(updateReportRequested()), this, SLOT(updateReportRequested()));
 
-	// Load data
-	triggerRepoRefresh();
+	connect(&m_prefetchWatch, SIGNAL(finished()), this, SLOT(prefetchPackageDetailsFinished()));
+
+	// Load data, pacman is only queried if the databases changed since the last run
+	if (restoreSnapshot()) {
+		prefetchPackageDetailsAsync();
+		updateFileOwnershipAsync();
+	}
+	else triggerRepoRefresh();
 	updateDistributionNewsAsync();
 	updateHelp(false);
 
 	// Optional commands
 	if (PacmanLogViewer::isAvailable()) ui->actionPacman_Log_Viewer->setEnabled(true);
+	if (PacmanDatabase::isSyncFilesAvailable(PacmanDatabase::getConfiguration())) ui->actionSearchByFile->setEnabled(true);
 	if (m_distribution.shouldFetchAurInfo()) {
 		fetchAurInformationAsync();
 	}
@@ -105,6 +118,8 @@ MainWindow::MainWindow(DistributionInfo& distribution, TaskProcessor& cpu,
 
 MainWindow::~MainWindow()
 {
+	m_prefetchCancelled = true;
+	m_prefetchWatch.waitForFinished();
 	ui->packageView->beforeshutdown(m_pkgRepo);
 	ui->groupBox->beforeshutdown(m_pkgRepo);
 	m_pkgRepo.deregisterDependency(*this);
@@ -145,42 +160,30 @@ void MainWindow::closeEvent(QCloseEvent* event)
 
 void MainWindow::triggerRepoRefresh()
 {
-	updateGroupListAsync(); //TODO: this does actually kill the group selection
-	updatePackageListAsync();
+	updatePackageListAsync(); // includes the package groups
 	updateForeignPackageListAsync();
-}
-
-void MainWindow::updateGroupListAsync()
-{
-	if (m_cpu.schedule(TaskProcessor::RemoveFirstOfTypePushBack, [this](){
-			updateStatusStartOfTask(strTaskLoadingGroups());
-			auto list = Pacman::getPackageGroups().release();
-			return [this, list](){
-					m_pkgRepo.checkAndSetGroups(*list);
-					updateStatusRunningTask(10);
-					delete list;
-			};
-	}, TaskProcessor::eTaskUpdateGroupList)) {
-	//then
-		updateStatusNewTask(10);
-	}
+	storeSnapshotAsync();
+	updateFileOwnershipAsync();
+	if (m_syncFiles != nullptr) updateSyncFilesAsync();
 }
 
 void MainWindow::updatePackageListAsync()
 {
 	if (m_cpu.schedule(TaskProcessor::RemoveFirstOfTypePushBack, [this](){
 			updateStatusStartOfTask(strTaskLoadingPackages());
-			auto list = Pacman::getPackageList().release();
-			auto unrequired = Pacman::getUnrequiredPackageList().release();
-			auto explicits = Pacman::getExplicitPackageList().release();
+			const PacmanDatabase::Configuration config = PacmanDatabase::getConfiguration();
+			const qint64 stamp = PacmanDatabase::getModificationStamp(config);
+			std::shared_ptr<const TLocalPackages> local(Pacman::getLocalPackages().release());
+			auto list = Pacman::getPackageList(*local).release();
 			updateStatusRunningTask(90);
-			return [this, list, unrequired, explicits](){
-					m_pkgRepo.setData(list, *unrequired, *explicits);
+			return std::function<void()>([this, list, local, config, stamp](){
+					m_pkgRepo.setData(list, *local);
+					m_pkgRepo.setDatabaseState(config, stamp);
+					m_localPackages = local;
+					prefetchPackageDetailsAsync();
 					updateStatusRunningTask(10);
 					delete list;
-					delete unrequired;
-					delete explicits;
-			};
+			});
 	}, TaskProcessor::eTaskUpdatePackageList)) {
 	//then
 		updateStatusNewTask(100);
@@ -192,22 +195,131 @@ void MainWindow::updateForeignPackageListAsync()
 	if (m_cpu.schedule(TaskProcessor::RemoveFirstOfTypePushBack, [this](){
 			updateStatusStartOfTask(strTaskLoadingForeignPackages());
 			auto list = Pacman::getPackageListForeign().release();
-			auto unrequired = Pacman::getUnrequiredPackageList().release();
+			// m_localPackages is only written by the follow ups, tasks run one after another
+			std::shared_ptr<const TLocalPackages> local = m_localPackages;
+			if (local == nullptr) local.reset(Pacman::getLocalPackages().release());
 			auto aur = m_distribution.retrieveAurInfo().release();
 			updateStatusRunningTask(40);
-			return [this, list, unrequired, aur](){
-					m_pkgRepo.setAURData(list, *unrequired, aur);
+			return std::function<void()>([this, list, local, aur](){
+					m_pkgRepo.setAURData(list, *local, aur);
+					m_localPackages.reset();
 					updateStatusRunningTask(10);
 					delete list;
-					delete unrequired;
 					delete aur;
-			};
+			});
 	}, TaskProcessor::eTaskUpdatePackageListForeign)) {
 	//then
 		updateStatusNewTask(50);
 	}
 }
 
+void MainWindow::prefetchPackageDetailsAsync()
+{
+	if (m_prefetchWatch.isRunning()) {
+		// reads the databases of the previous refresh, started again once it gave up
+		m_prefetchCancelled = true;
+		m_prefetchRestart = true;
+		return;
+	}
+	m_prefetchCancelled = false;
+	const qint64 stamp = m_pkgRepo.getDatabaseStamp();
+	m_prefetchWatch.setFuture(QtConcurrent::run(this, &MainWindow::prefetchPackageDetails, stamp));
+}
+
+/**
+ * @brief runs in the thread pool, must not touch anything but the cancel flag
+ */
+void MainWindow::prefetchPackageDetails(const qint64 stamp)
+{
+	Pacman::prefetchPackageDetails(stamp, m_prefetchCancelled);
+}
+
+void MainWindow::prefetchPackageDetailsFinished()
+{
+	if (m_prefetchRestart == false)
+		return;
+	m_prefetchRestart = false;
+	prefetchPackageDetailsAsync();
+}
+
+bool MainWindow::restoreSnapshot()
+{
+	const PacmanDatabase::Configuration config = PacmanDatabase::getConfiguration();
+	const qint64 stamp = PacmanDatabase::getModificationStamp(config);
+	if (stamp == 0 ||
+	    m_pkgRepo.restoreSnapshot(QDir::homePath() + QDir::separator() + strCacheDir() + "packages.snapshot",
+	                              stamp) == false)
+		return false;
+
+	m_pkgRepo.setDatabaseState(config, stamp);
+	return true;
+}
+
+void MainWindow::storeSnapshotAsync()
+{
+	// tasks run one after another, the repository will not change while the task is running
+	m_cpu.schedule(TaskProcessor::RemoveFirstOfTypePushBack, [this](){
+			if (m_pkgRepo.getDatabaseStamp() != 0) {
+				const QString path(QDir::homePath() + QDir::separator() + strCacheDir());
+				QDir().mkpath(path);
+				m_pkgRepo.storeSnapshot(path + "packages.snapshot", m_pkgRepo.getDatabaseStamp());
+			}
+			return [](){};
+	}, TaskProcessor::eTaskStoreSnapshot);
+}
+
+void MainWindow::updateFileOwnershipAsync()
+{
+	// m_fileOwnershipStamp and the database state of m_pkgRepo are only written by follow ups, tasks run one after another
+	if (m_cpu.schedule(TaskProcessor::RemoveFirstOfTypePushBack, [this](){
+			const PacmanDatabase::Configuration& config = m_pkgRepo.getDatabaseConfiguration();
+			const qint64 stamp = m_pkgRepo.getDatabaseStamp();
+			if (stamp == 0 || (m_fileOwnership != nullptr && stamp == m_fileOwnershipStamp)) {
+				updateStatusRunningTask(50);
+				return std::function<void()>([](){});
+			}
+			updateStatusStartOfTask(strTaskLoadingFileOwnership());
+			std::shared_ptr<const FileOwnershipIndex> index(PacmanDatabase::getFileOwnershipIndex(config).release());
+			updateStatusRunningTask(50);
+			return std::function<void()>([this, index, stamp](){
+					if (index == nullptr) return; // no readable local database
+					m_fileOwnership = index;
+					m_fileOwnershipStamp = stamp;
+					if (m_dlgWhatProvidesMe != nullptr) m_dlgWhatProvidesMe->setFileOwnershipIndex(m_fileOwnership);
+			});
+	}, TaskProcessor::eTaskUpdateFileOwnership)) {
+	//then
+		updateStatusNewTask(50);
+	}
+}
+
+void MainWindow::updateSyncFilesAsync()
+{
+	// m_syncFilesStamp is only written by the follow up, tasks run one after another
+	if (m_cpu.schedule(TaskProcessor::RemoveFirstOfTypePushBack, [this](){
+			const PacmanDatabase::Configuration config = PacmanDatabase::getConfiguration();
+			const qint64 stamp = PacmanDatabase::getSyncFilesModificationStamp(config);
+			if (m_syncFiles != nullptr && stamp == m_syncFilesStamp) {
+				updateStatusRunningTask(50);
+				return std::function<void()>([](){});
+			}
+			updateStatusStartOfTask(strTaskLoadingSyncFiles());
+			std::shared_ptr<const FileOwnershipIndex> index(PacmanDatabase::getSyncFilesIndex(config).release());
+			updateStatusRunningTask(50);
+			return std::function<void()>([this, index, stamp](){
+					if (index == nullptr) return;
+					m_syncFiles = index;
+					m_syncFilesStamp = stamp;
+					applyFilterChange([this](DefaultPackageFilter& filter){
+						filter.applySearchFilter(m_lePkgSearch->text(), m_syncFiles);
+					});
+			});
+	}, TaskProcessor::eTaskUpdateSyncFiles)) {
+	//then
+		updateStatusNewTask(50);
+	}
+}
+
 void MainWindow::fetchAurInformationAsync()
 {
 	if (m_cpu.schedule(TaskProcessor::OnlyOne, [this](){
@@ -264,16 +376,17 @@ void MainWindow::updatePackageInfoTabAsync(const PackageRepository::PackageData&
 	if (package.managedByYaourt)
 		aurData = new PackageListData(package.name, package.repository, package.version, "", package.status);
 
-	if (m_cpu.schedule(TaskProcessor::RemoveFirstOfTypePushBack, [this, packageName, packageRepo, installed, aurData](){
+	const qint64 stamp = m_pkgRepo.getDatabaseStamp();
+	if (m_cpu.schedule(TaskProcessor::RemoveFirstOfTypePushBack, [this, packageName, packageRepo, installed, aurData, stamp](){
 			updateStatusStartOfTask(strTaskUpdatePackageInfo());
 			QList<PackageDetailData>* list, * listInstalled;
 			if (aurData) {
-				list          = Pacman::getPackageDetails(packageName, true).release();
+				list          = Pacman::getPackageDetails(packageName, true, stamp).release();
 				listInstalled = nullptr;
 			}
 			else {
-				list          = Pacman::getPackageDetails(packageRepo + "/" + packageName, false).release();
-				listInstalled = installed ? Pacman::getPackageDetails(packageName, true).release() : nullptr;
+				list          = Pacman::getPackageDetails(packageRepo + "/" + packageName, false, stamp).release();
+				listInstalled = installed ? Pacman::getPackageDetails(packageName, true, stamp).release() : nullptr;
 			}
 			updateStatusRunningTask(19);
 			return [this, list, listInstalled, aurData](){
@@ -309,31 +422,15 @@ void MainWindow::selectionChanged(const QItemSelection&, const QItemSelection&)
 void MainWindow::filterChanged(const DefaultPackageFilter* newFilter)
 {
 	DefaultPackageFilter*const filter = new DefaultPackageFilter(*newFilter);
-	applySearchFilterColumn(*filter,
-	                        ui->actionSearchByName->isChecked()
-	                        ? PackageModel::ctn_PACKAGE_NAME_COLUMN
-	                        : PackageModel::ctn_PACKAGE_DESCRIPTION_FILTER_NO_COLUMN);
+	applySearchFilterColumn(*filter, getSearchFilterColumn());
 	applySearchFilter(*filter, m_lePkgSearch->text());
 	ui->packageView->setFilter(std::unique_ptr<IPackageFilter>(filter));
-	m_statusbar->updateSelected(ui->packageView->getSelectedPackageCount());
 }
 
-void MainWindow::loadGroupMemberList(QString group)
-{
-	if (m_pkgRepo.getPackageList(group).empty()) {
-		if (m_cpu.schedule(TaskProcessor::RemoveFirstOfTypePushBack, [this, group](){
-				updateStatusStartOfTask(strTaskUpdateGroupMembers());
-				auto list = Pacman::getPackageListForGroup(group).release();
-				return [this, group, list](){
-						m_pkgRepo.checkAndSetMembersOfGroup(group, *list);
-						updateStatusRunningTask(40);
-						delete list;
-				};
-		}, TaskProcessor::eTaskUpdateGroupMembers)) {
-		//then
-			updateStatusNewTask(40);
-		}
-	}
+void MainWindow::packageRowsEvaluated()
+{
+	// Filter may change package selection
+	m_statusbar->updateSelected(ui->packageView->getSelectedPackageCount());
 }
 
 void MainWindow::onRequestForContextMenu(QPoint pt, QList<const PackageRepository::PackageData*>* list)
@@ -381,22 +478,24 @@ void MainWindow::updateReportRequested()
 	QString packageNames;
 	QString pmPackages;
 	QString aurPackages;
-	for (auto& pkg : m_pkgRepo.getPackageList()) {
-		switch (pkg->status) {
+	const PackageStore& store = m_pkgRepo.getStore();
+	for (const quint32 id : store.getIds()) {
+		switch (store.status(id)) {
 		case epkg_FOREIGN_OUTDATED:
-			aurPackages += " " + pkg->name;
+			aurPackages += " " + store.name(id);
 			break;
 		case epkg_NEWER:
 		case epkg_OUTDATED:
-			packageNames += " " + pkg->name;
-			pmPackages   += " " + pkg->repository + "/" + pkg->name;
+			packageNames += " " + store.name(id);
+			pmPackages   += " " + store.getRepositories()[store.repositoryId(id)] + "/" + store.name(id);
 			break;
 		default:
 			continue;
 		}
 	}
 
-	if (m_cpu.schedule(TaskProcessor::RemoveFirstOfTypePushBack, [this, packageNames, pmPackages, aurPackages](){
+	const qint64 stamp = m_pkgRepo.getDatabaseStamp();
+	if (m_cpu.schedule(TaskProcessor::RemoveFirstOfTypePushBack, [this, packageNames, pmPackages, aurPackages, stamp](){
 			updateStatusStartOfTask(strTaskUpdateReport());
 			QList<PackageDetailData>* listPmRepo, * listPmInstalled, * listAurInstalled;
 			if (packageNames.isEmpty()) {
@@ -404,14 +503,14 @@ void MainWindow::updateReportRequested()
 				listPmInstalled = new QList<PackageDetailData>();
 			}
 			else {
-				listPmRepo      = Pacman::getPackageDetails(pmPackages, false).release();
-				listPmInstalled = Pacman::getPackageDetails(packageNames, true).release();
+				listPmRepo      = Pacman::getPackageDetails(pmPackages, false, stamp).release();
+				listPmInstalled = Pacman::getPackageDetails(packageNames, true, stamp).release();
 			}
 			updateStatusRunningTask(15);
 			if (aurPackages.isEmpty()) {
 				listAurInstalled = new QList<PackageDetailData>();
 			}
-			else listAurInstalled = Pacman::getPackageDetails(aurPackages, true).release();
+			else listAurInstalled = Pacman::getPackageDetails(aurPackages, true, stamp).release();
 			auto aurInfo = m_distribution.retrieveAurInfo().release();
 			updateStatusRunningTask(10);
 			return [this, listPmInstalled, listPmRepo, listAurInstalled, aurInfo](){
@@ -449,6 +548,10 @@ void MainWindow::onActionSearchByX_triggered(QAction* action)
 	else if (action == ui->actionSearchByDescription) {
 		temp = PackageModel::ctn_PACKAGE_DESCRIPTION_FILTER_NO_COLUMN;
 	}
+	else if (action == ui->actionSearchByFile) {
+		temp = PackageModel::ctn_PACKAGE_FILE_FILTER_NO_COLUMN;
+		updateSyncFilesAsync(); // read on first use
+	}
 	// bind filter
 	auto fnc = std::bind(&MainWindow::applySearchFilterColumn,
 	                     this, std::placeholders::_1, temp);
@@ -477,17 +580,15 @@ void MainWindow::updateStatusRunningTask(int progressIncrement)
 
 void MainWindow::applyFilterChange(std::function<void (DefaultPackageFilter&)> fnc)
 {
-	// Filter change must be model synchronized with Qt
+	// Filter change must be model synchronized with Qt, the rows follow (see packageRowsEvaluated)
 	ui->packageView->syncFilterChange([=](IPackageFilter& filter){
 		fnc(static_cast<DefaultPackageFilter&>(filter));
 	});
-	// Filter may change package selection
-	m_statusbar->updateSelected(ui->packageView->getSelectedPackageCount());
 }
 
 void MainWindow::applySearchFilter(DefaultPackageFilter& filter, const QString& searchStr)
 {
-	filter.applySearchFilter(adaptSearchString(searchStr, false));
+	filter.applySearchFilter(searchStr, m_syncFiles);
 }
 
 void MainWindow::applySearchFilterColumn(DefaultPackageFilter& filter, const int filterColumn)
@@ -495,48 +596,21 @@ void MainWindow::applySearchFilterColumn(DefaultPackageFilter& filter, const int
 	filter.applySearchFilter(filterColumn);
 }
 
-/*
- * Returns a modified RegExp-based string given the string entered by the user
- *
- * from Octopi
- */
-QString MainWindow::adaptSearchString(QString searchStr, bool exactMatch)
+int MainWindow::getSearchFilterColumn() const
 {
-  if (searchStr.indexOf("*.") == 0){
-    searchStr = searchStr.remove(0, 2);
-    searchStr.insert(0, "\\S+\\.");
-  }
-
-  if (searchStr.indexOf("*") == 0){
-    searchStr = searchStr.remove(0, 1);
-    searchStr.insert(0, "\\S+");
-  }
-
-  if (searchStr.endsWith("*")){
-    searchStr.remove(searchStr.length()-1, 1);
-    searchStr.append("\\S*");
-  }
-
-  if (searchStr.indexOf("^") == -1 && searchStr.indexOf("\\S") != 0){
-    if (!exactMatch) searchStr.insert(0, "\\S*");
-    else searchStr.insert(0, "^");
-  }
-
-  if (searchStr.indexOf("$") == -1){
-    if (!exactMatch && !searchStr.endsWith("\\S*")) searchStr.append("\\S*");
-    else searchStr.append("$");
-  }
-
-  searchStr.replace("?", ".");
-  return searchStr;
+	if (ui->actionSearchByName->isChecked())
+		return PackageModel::ctn_PACKAGE_NAME_COLUMN;
+	if (ui->actionSearchByFile->isChecked())
+		return PackageModel::ctn_PACKAGE_FILE_FILTER_NO_COLUMN;
+	return PackageModel::ctn_PACKAGE_DESCRIPTION_FILTER_NO_COLUMN;
 }
 
-void MainWindow::endResetRepository(PackageRepository::EResetType type)
+void MainWindow::endResetRepository(PackageRepository::EResetType)
 {
-	if (type == PackageRepository::eResetGroupList)
-		return;
-
 	m_statusbar->updatePackagesInfo(m_pkgRepo.countInstalled(), m_pkgRepo.countOutdated(false), m_pkgRepo.countTotal());
+	const PackageRepository::PackageArenaStatistics memory = m_pkgRepo.getArenaStatistics();
+	m_statusbar->updatePackagesMemory(memory.bytesUsed, memory.bytesReserved, memory.blocks, memory.allocations,
+	                                  memory.generations);
 }
 
 void MainWindow::on_actionRoot_Terminal_triggered()
@@ -606,7 +680,8 @@ void MainWindow::on_actionAbout_triggered()
 
 void MainWindow::on_actionWhatProvides_triggered()
 {
-	DlgWhatProvidesMe* dlg = new DlgWhatProvidesMe(this);
+	DlgWhatProvidesMe* dlg = new DlgWhatProvidesMe(m_fileOwnership, this);
+	m_dlgWhatProvidesMe = dlg;
 	dlg->show();
 }
 
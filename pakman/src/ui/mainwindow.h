@@ -22,7 +22,10 @@
 #define MAINWINDOW_H
 
 #include <atomic>
+#include <memory>
 #include <QMainWindow>
+#include <QPointer>
+#include <QFutureWatcher>
 #include <QLineEdit>
 #include <QItemSelection>
 #include "src/ui/statusbar.h"
@@ -35,6 +38,8 @@ namespace Ui {
 class MainWindow;
 }
 class DistributionInfo;
+class DlgWhatProvidesMe;
+class FileOwnershipIndex;
 
 
 class MainWindow : public QMainWindow, private PackageRepository::IDependency
@@ -87,11 +92,20 @@ public:
 	// will invalidate Repo-pointers !!!
 	void triggerRepoRefresh();
 	// will invalidate Repo-pointers !!!
-	void updateGroupListAsync();
-	// will invalidate Repo-pointers !!!
 	void updatePackageListAsync();
 	// will invalidate Repo-pointers !!!
 	void updateForeignPackageListAsync();
+	// reads the details of all packages in advance (beside the task processor, see m_prefetchWatch)
+	void prefetchPackageDetailsAsync();
+	void prefetchPackageDetails(const qint64 stamp);
+	// will invalidate Repo-pointers !!!, false if the snapshot is outdated
+	bool restoreSnapshot();
+	// writes the repository content for the next start
+	void storeSnapshotAsync();
+	// reads the files lists of the installed packages (only if the databases changed)
+	void updateFileOwnershipAsync();
+	// reads the .files databases for the search by file (only if they changed)
+	void updateSyncFilesAsync();
 
 	// will store the information in a temp location
 	void fetchAurInformationAsync();
@@ -110,8 +124,10 @@ public:
 private slots:
 	// PackageView selection changed
 	void selectionChanged(const QItemSelection&, const QItemSelection&);
+	// PackageView rows filtered or sorted
+	void packageRowsEvaluated();
+	void prefetchPackageDetailsFinished();
 	void filterChanged(const DefaultPackageFilter* newFilter);
-	void loadGroupMemberList(QString group); // loads only if not already available
 	void onRequestForContextMenu(QPoint, QList<const PackageRepository::PackageData*>*);
 	// Search LineEdit
 	void searchEditChanged(const QString&);
@@ -150,6 +166,15 @@ private:
 	Ui::MainWindow*   ui;
 	StatusBar*const   m_statusbar;   // WEAK
 	QLineEdit*        m_lePkgSearch; // WEAK
+	std::shared_ptr<const TLocalPackages>     m_localPackages;      // read by the package list, reused by the foreign one
+	std::shared_ptr<const FileOwnershipIndex> m_fileOwnership;      // nullptr until read
+	qint64                                    m_fileOwnershipStamp; // database modification stamp of m_fileOwnership
+	QPointer<DlgWhatProvidesMe>               m_dlgWhatProvidesMe;  // WEAK, receives m_fileOwnership updates
+	std::shared_ptr<const FileOwnershipIndex> m_syncFiles;          // nullptr until searched by file
+	qint64                                    m_syncFilesStamp;     // .files modification stamp of m_syncFiles
+	QFutureWatcher<void>                      m_prefetchWatch;      // user triggered tasks must not wait for the prefetch
+	std::atomic<bool>                         m_prefetchCancelled;
+	bool                                      m_prefetchRestart;    // a refresh came in while the prefetch was running
 
 private:
 	void updateStatusNewTask(int maxIncrement);
@@ -159,7 +184,7 @@ private:
 	void applyFilterChange(std::function<void(DefaultPackageFilter&)> fnc);
 	void applySearchFilter(DefaultPackageFilter& filter, const QString& searchStr);
 	void applySearchFilterColumn(DefaultPackageFilter& filter, const int filterColumn);
-	QString adaptSearchString(QString searchStr, bool exactMatch);
+	int getSearchFilterColumn() const;
 
 	// QWidget
 	virtual void closeEvent(QCloseEvent* event) override;
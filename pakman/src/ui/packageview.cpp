@@ -53,6 +53,7 @@ void PackageView::initialize(PackageRepository& repo)
 
 	connect(ui->treeView->selectionModel(), SIGNAL(selectionChanged(QItemSelection,QItemSelection)),
 	        this, SIGNAL(selectionChanged(QItemSelection,QItemSelection)), Qt::DirectConnection);
+	connect(m_pkgViewModel.get(), SIGNAL(rowsEvaluated()), this, SIGNAL(rowsEvaluated()));
 
 	// Resize columns
 	ui->treeView->setColumnWidth(0, 24);
@@ -64,6 +64,10 @@ signals:
 	 * List must be deleted by receiver, only for one receiver and for direct connection !
 	 */
 	void requestContextMenu(QPoint, QList<const PackageRepository::PackageData*>*);
+	/**
+	 * @brief the rows have been filtered or sorted again (see PackageModel::rowsEvaluated)
+	 */
+	void rowsEvaluated();
 
 public slots:
 	void sort(int column, Qt::SortOrder order);
@@ -40,6 +40,9 @@ StatusBar::StatusBar(QWidget *parent)
 	        this, SLOT(changeSelected(int)), Qt::QueuedConnection);
 	connect(this, SIGNAL(changePackagesInfoSignal(int,int,int)),
 	        this, SLOT(changePackagesInfo(int,int,int)), Qt::QueuedConnection);
+	connect(this, SIGNAL(changePackagesMemorySignal(qulonglong,qulonglong,qulonglong,qulonglong,qulonglong)),
+	        this, SLOT(changePackagesMemory(qulonglong,qulonglong,qulonglong,qulonglong,qulonglong)),
+	        Qt::QueuedConnection);
 
 	m_progress->setMaximumWidth(75);
 	addWidget(m_labelSelPkgCount);
@@ -93,3 +96,11 @@ void StatusBar::changePackagesInfo(int installed, int outdated, int total)
 	}
 	m_labelPkgCount->setText(QString::number(total) + " " + strPackageTotal());
 }
+
+/// tooltip of "%number total"
+void StatusBar::changePackagesMemory(qulonglong used, qulonglong reserved, qulonglong blocks, qulonglong allocations,
+                                     qulonglong generations)
+{
+	m_labelPkgCount->setToolTip(strPackageMemory().arg(used / 1024).arg(reserved / 1024).arg(blocks)
+	                                              .arg(allocations).arg(generations));
+}
@@ -41,6 +41,13 @@ public:
 	inline void updatePackagesInfo(int installed, int outdated, int total) {
 		emit changePackagesInfoSignal(installed, outdated, total);
 	}
+	/**
+	 * @brief memory of the package data (see PackageRepository::getArenaStatistics), shown as tooltip of the total
+	 */
+	inline void updatePackagesMemory(qulonglong used, qulonglong reserved, qulonglong blocks, qulonglong allocations,
+	                                 qulonglong generations) {
+		emit changePackagesMemorySignal(used, reserved, blocks, allocations, generations);
+	}
 
 private:
 	QLabel*const  m_labelPkgCount;     //WEAK
@@ -58,12 +65,16 @@ signals:
 	void changeStatusSignal(QString activity, int val, int max);
 	void changeSelectedSignal(int selected);
 	void changePackagesInfoSignal(int installed, int outdated, int total);
+	void changePackagesMemorySignal(qulonglong used, qulonglong reserved, qulonglong blocks, qulonglong allocations,
+	                                qulonglong generations);
 	void updateReportRequested();
 
 private slots:
 	void changeStatusImpl(QString activity, int val, int max);
 	void changeSelected(int selected);
 	void changePackagesInfo(int installed, int outdated, int total);
+	void changePackagesMemory(qulonglong used, qulonglong reserved, qulonglong blocks, qulonglong allocations,
+	                          qulonglong generations);
 
 private:
 	inline QLabel* crtNlbl() {
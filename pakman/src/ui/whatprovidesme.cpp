@@ -21,11 +21,53 @@
 #include "whatprovidesme.h"
 #include "ui_whatprovidesme.h"
 
-#include "src/commands/pacmancommands.h"
+#include <QDir>
+#include <QFileInfo>
+#include <QTextDocument>
 
+#include "src/strconstants.h"
+#include "src/data/fileownershipindex.h"
 
-DlgWhatProvidesMe::DlgWhatProvidesMe(QWidget *parent)
-	: QDialog(parent), ui(new Ui::DlgWhatProvidesMe)
+
+namespace {
+
+inline QString escaped(const QString& text)
+{
+#if QT_VERSION >= 0x050000
+	return text.toHtmlEscaped();
+#else
+	return Qt::escape(text);
+#endif
+}
+
+/**
+ * @brief absolute path the way "-Qo" resolves it
+ *
+ * plain names are searched in $PATH, symlinks are resolved in the directory part only
+ */
+QString resolvePath(const QString& input)
+{
+	if (input.contains('/') == false) {
+		foreach (const QString& dir, QString::fromLocal8Bit(qgetenv("PATH")).split(':', QString::SkipEmptyParts)) {
+			const QFileInfo info(QDir(dir), input);
+			if (info.isFile() && info.isExecutable())
+				return resolvePath(info.absoluteFilePath());
+		}
+		return input;
+	}
+
+	const QFileInfo info(input);
+	const QString directory = QDir(info.absolutePath()).canonicalPath();
+	if (directory.isEmpty())
+		return info.absoluteFilePath();
+	return (directory.endsWith('/') ? directory : directory + '/') + info.fileName();
+}
+
+}
+
+
+DlgWhatProvidesMe::DlgWhatProvidesMe(const std::shared_ptr<const FileOwnershipIndex>& index, QWidget *parent)
+	: QDialog(parent), ui(new Ui::DlgWhatProvidesMe), m_index(index), m_lookupPending(false)
 {
 	ui->setupUi(this);
 }
@@ -35,8 +77,48 @@ DlgWhatProvidesMe::~DlgWhatProvidesMe()
 	delete ui;
 }
 
+void DlgWhatProvidesMe::setFileOwnershipIndex(const std::shared_ptr<const FileOwnershipIndex>& index)
+{
+	m_index = index;
+	if (m_lookupPending && m_index != nullptr) {
+		m_lookupPending = false;
+		lookup();
+	}
+}
+
 void DlgWhatProvidesMe::on_pushButton_clicked()
 {
-	QString text = PacmanCommands::getProviderFor(ui->lineEdit->text());
-	ui->result->setText("Result:<br><b>" + text + "</b>");
+	if (m_index == nullptr) {
+		// "-Qo" would block the UI, the index follows from the task processor
+		m_lookupPending = true;
+		ui->result->setText(escaped(strFileOwnershipPending()));
+		return;
+	}
+	lookup();
+}
+
+/**
+ * @brief one result line per (pasted) path
+ */
+void DlgWhatProvidesMe::lookup()
+{
+	QString text;
+	foreach (const QString& line, ui->paths->toPlainText().split('\n', QString::SkipEmptyParts)) {
+		const QString input = line.trimmed();
+		if (input.isEmpty())
+			continue;
+
+		const QString path = resolvePath(input);
+		const FileOwnershipIndex::TOwners owners = m_index->findOwners(path);
+		if (owners.empty()) {
+			text += strFileNotOwned().arg(escaped(path)) + "<br>";
+			continue;
+		}
+		QStringList packages;
+		for (FileOwnershipIndex::TOwners::const_iterator it = owners.begin(); it != owners.end(); ++it) {
+			packages << "<b>" + escaped((*it)->name + " " + (*it)->version) + "</b>";
+		}
+		text += strFileOwnedBy().arg(escaped(path), packages.join(", ")) + "<br>";
+	}
+	ui->result->setText("Result:<br>" + text);
 }
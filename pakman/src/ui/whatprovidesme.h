@@ -21,26 +21,37 @@
 #ifndef WHATPROVIDESME_H
 #define WHATPROVIDESME_H
 
+#include <memory>
 #include <QDialog>
 
 namespace Ui {
 class DlgWhatProvidesMe;
 }
+class FileOwnershipIndex;
 
 class DlgWhatProvidesMe : public QDialog
 {
 	Q_OBJECT
 
 public:
-	explicit DlgWhatProvidesMe(QWidget *parent = 0);
+	/**
+	 * @param index (may be nullptr while it is being built, lookups wait for setFileOwnershipIndex then)
+	 */
+	explicit DlgWhatProvidesMe(const std::shared_ptr<const FileOwnershipIndex>& index, QWidget *parent = 0);
 	~DlgWhatProvidesMe();
 
+	void setFileOwnershipIndex(const std::shared_ptr<const FileOwnershipIndex>& index);
 
 private slots:
 	void on_pushButton_clicked();
 
+private:
+	void lookup();
+
 private:
 	Ui::DlgWhatProvidesMe *ui;
+	std::shared_ptr<const FileOwnershipIndex> m_index;
+	bool m_lookupPending; // clicked before the index was ready
 };
 
 #endif // WHATPROVIDESME_H